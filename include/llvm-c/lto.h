@@ -27,7 +27,7 @@
  * @{
  */
 
-#define LTO_API_VERSION 4
+#define LTO_API_VERSION 5
 
 typedef enum {
     LTO_SYMBOL_ALIGNMENT_MASK              = 0x0000001F, /* log2 of alignment */
@@ -284,6 +284,27 @@ lto_codegen_compile(lto_code_gen_t cg, size_t* length);
 extern bool
 lto_codegen_compile_to_file(lto_code_gen_t cg, const char** name);
 
+/**
+ * Sets the number of partitions the merged module is split into by
+ * lto_codegen_compile_partitions_to_files().  The partitions are generated
+ * in parallel.  The default is 1.
+ */
+extern void
+lto_codegen_set_partitions(lto_code_gen_t cg, unsigned partitions);
+
+/**
+ * Generates code for all added modules into one native object file per
+ * partition.  On success, names is set to an array of count file names, all
+ * of which must be passed to the linker.  The array is owned by the
+ * lto_code_gen_t and will be freed when lto_codegen_dispose() is called, or
+ * this function is called again.  Returns true on error (check
+ * lto_get_error_message() for details).
+ */
+extern bool
+lto_codegen_compile_partitions_to_files(lto_code_gen_t cg,
+                                        const char*** names,
+                                        unsigned* count);
+
 
 /**
  * Sets options to help debug codegen bugs.
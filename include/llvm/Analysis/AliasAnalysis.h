@@ -37,6 +37,7 @@
 #ifndef LLVM_ANALYSIS_ALIASANALYSIS_H
 #define LLVM_ANALYSIS_ALIASANALYSIS_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/CallSite.h"
 
@@ -171,6 +172,13 @@ public:
   /// alias analysis implementations.
   virtual AliasResult alias(const Location &LocA, const Location &LocB);
 
+  /// aliasBatch - Query LocA against each of Others, appending one result per
+  /// location to Results in the same order.  Implementations that can share
+  /// work between the queries, such as examining LocA, may override this.  The
+  /// default asks alias() about each pair.
+  virtual void aliasBatch(const Location &LocA, ArrayRef<Location> Others,
+                          SmallVectorImpl<AliasResult> &Results);
+
   /// alias - A convenience wrapper.
   AliasResult alias(const Value *V1, uint64_t V1Size,
                     const Value *V2, uint64_t V2Size) {
@@ -580,6 +588,34 @@ struct DenseMapInfo<AliasAnalysis::Location> {
   }
 };
 
+/// AliasQueryCache - Remembers the answers to the alias queries made through
+/// it, for a client that asks about the same pairs of locations many times.
+/// The answers only stay valid while no values are deleted, since a new value
+/// may be allocated at the address of a deleted one.  Clients should create
+/// one for a run of their pass and clear() it whenever they delete values.
+class AliasQueryCache {
+  typedef std::pair<AliasAnalysis::Location, AliasAnalysis::Location> LocPair;
+
+  AliasAnalysis *AA;
+  DenseMap<LocPair, AliasAnalysis::AliasResult> Cache;
+
+public:
+  explicit AliasQueryCache(AliasAnalysis *AA) : AA(AA) {}
+
+  /// alias - Return the cached answer for the pair, or ask the alias analysis.
+  AliasAnalysis::AliasResult alias(const AliasAnalysis::Location &LocA,
+                                   const AliasAnalysis::Location &LocB);
+
+  /// aliasBatch - Query LocA against each of Others.  The locations without
+  /// a cached answer are passed to the alias analysis as a single batch.
+  void aliasBatch(const AliasAnalysis::Location &LocA,
+                  ArrayRef<AliasAnalysis::Location> Others,
+                  SmallVectorImpl<AliasAnalysis::AliasResult> &Results);
+
+  /// clear - Forget all answers.
+  void clear() { Cache.clear(); }
+};
+
 /// isNoAliasCall - Return true if this pointer is returned by a noalias
 /// function.
 bool isNoAliasCall(const Value *V);
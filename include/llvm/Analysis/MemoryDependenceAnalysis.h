@@ -285,8 +285,12 @@ namespace llvm {
       /// TBAATag - The TBAA tag associated with dereferences of the
       /// pointer. May be null if there are no tags or conflicting tags.
       const MDNode *TBAATag;
+      /// LastQuery - The number of the last top-level query that used this
+      /// entry. The least recently used entries are evicted first.
+      unsigned LastQuery;
 
-      NonLocalPointerInfo() : Size(AliasAnalysis::UnknownSize), TBAATag(0) {}
+      NonLocalPointerInfo()
+        : Size(AliasAnalysis::UnknownSize), TBAATag(0), LastQuery(0) {}
     };
 
     /// CachedNonLocalPointerInfo - This map stores the cached results of doing
@@ -301,6 +305,14 @@ namespace llvm {
                      SmallPtrSet<ValueIsLoadPair, 4> > ReverseNonLocalPtrDepTy;
     ReverseNonLocalPtrDepTy ReverseNonLocalPtrDeps;
 
+    /// NumNonLocalPtrQueries - The number of top-level non-local pointer
+    /// queries made so far, used to order NonLocalPointerDeps by last use.
+    unsigned NumNonLocalPtrQueries;
+
+    /// NumNonLocalPtrEntries - An upper bound on the number of block entries
+    /// in NonLocalPointerDeps. It is only made exact when it exceeds the cache
+    /// budget.
+    unsigned NumNonLocalPtrEntries;
 
     /// PerInstNLInfo - This is the instruction we keep for each cached access
     /// that we have for an instruction.  The pointer is an owning pointer and
@@ -326,6 +338,10 @@ namespace llvm {
     DataLayout *TD;
     DominatorTree *DT;
     OwningPtr<PredIteratorCache> PredCache;
+
+    /// ScanLimit - The number of instructions to scan in a block before giving
+    /// up. Depends on the size of the current function.
+    unsigned ScanLimit;
   public:
     MemoryDependenceAnalysis();
     ~MemoryDependenceAnalysis();
@@ -434,6 +450,10 @@ namespace llvm {
 
     void RemoveCachedNonLocalPointerDependencies(ValueIsLoadPair P);
 
+    /// shrinkNonLocalPointerCache - Evict the least recently used entries of
+    /// NonLocalPointerDeps until it fits in half the cache budget.
+    void shrinkNonLocalPointerCache();
+
     /// verifyRemoved - Verify that the specified instruction does not occur
     /// in our internal data structures.
     void verifyRemoved(Instruction *Inst) const;
@@ -543,6 +543,14 @@ namespace llvm {
     /// forgetMemoizedResults - Drop memoized information computed for S.
     void forgetMemoizedResults(const SCEV *S);
 
+    /// isTooComplex - Return true if S has more nodes than an expression
+    /// built for a single value is allowed to have.
+    bool isTooComplex(const SCEV *S) const;
+
+    /// printStatistics - Print the number of SCEV nodes of each kind and the
+    /// sizes of the caches, for -scev-stats.
+    void printStatistics(raw_ostream &OS) const;
+
   public:
     static char ID; // Pass identification, replacement for typeid
     ScalarEvolution();
@@ -42,7 +42,9 @@ namespace bitc {
 
     TYPE_BLOCK_ID_NEW,
 
-    USELIST_BLOCK_ID
+    USELIST_BLOCK_ID,
+
+    FUNCTION_INDEX_BLOCK_ID
   };
 
 
@@ -330,6 +332,17 @@ namespace bitc {
   enum UseListCodes {
     USELIST_CODE_ENTRY = 1   // USELIST_CODE_ENTRY: TBD.
   };
+
+  /// The function index block (FUNCTION_INDEX_BLOCK_ID) precedes the function
+  /// bodies and records where each of them starts, so that a reader can jump
+  /// straight to a body instead of skipping over all the blocks before it.
+  enum FunctionIndexCodes {
+    // OFFSETS: [blob] One little-endian 64-bit bit offset per function body,
+    // in the order of the bodies, followed by the offset just past the last
+    // body.  A body offset points just after the FUNCTION_BLOCK_ID of the
+    // ENTER_SUBBLOCK that opens the body.
+    FUNC_INDEX_CODE_OFFSETS = 1
+  };
 } // End bitc namespace
 } // End llvm namespace
 
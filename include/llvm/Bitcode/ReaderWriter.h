@@ -58,6 +58,29 @@ namespace llvm {
   Module *ParseBitcodeFile(MemoryBuffer *Buffer, LLVMContext &Context,
                            std::string *ErrMsg = 0);
 
+  /// ParallelBitcodeCallback - Called by materializeBitcodeInParallel on a
+  /// worker thread.  \p M lives in an LLVMContext private to the thread and
+  /// is destroyed, along with the context, when the callback returns.
+  typedef void (*ParallelBitcodeCallback)(Module *M, unsigned Partition,
+                                          void *Cookie);
+
+  /// materializeBitcodeInParallel - Read the bitcode in Buffer on NumThreads
+  /// threads.  Each thread lazily reads the module into its own LLVMContext,
+  /// materializes its share of the function bodies and passes the module to
+  /// Callback.  The bodies are split into contiguous ranges of about the same
+  /// size in the stream, so every body is materialized by exactly one thread;
+  /// the others are left materializable.  Functions that are referenced by a
+  /// blockaddress from a global initializer are materialized by all threads.
+  ///
+  /// Buffer is not taken over and must stay alive until this returns.  If
+  /// LLVM is not in multithreaded mode yet, it is switched into it for the
+  /// duration of the call.  On error, this returns false and fills in *ErrMsg
+  /// if ErrMsg is non-null.
+  bool materializeBitcodeInParallel(const MemoryBuffer *Buffer,
+                                    unsigned NumThreads,
+                                    ParallelBitcodeCallback Callback,
+                                    void *Cookie, std::string *ErrMsg = 0);
+
   /// WriteBitcodeToFile - Write the specified module to the specified
   /// raw output stream.  For streams where it matters, the given stream
   /// should be in "binary" mode.
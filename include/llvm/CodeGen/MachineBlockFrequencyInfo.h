@@ -29,6 +29,9 @@ class BlockFrequencyImpl;
 /// machine basic block frequencies.
 class MachineBlockFrequencyInfo : public MachineFunctionPass {
 
+  /// MBFI - The frequencies of the current function. They are owned by the
+  /// MachineFunction so that they can be reused while the CFG, including the
+  /// edge weights, is unchanged.
   BlockFrequencyImpl<MachineBasicBlock, MachineFunction,
                      MachineBranchProbabilityInfo> *MBFI;
 
@@ -43,6 +46,8 @@ public:
 
   bool runOnMachineFunction(MachineFunction &F);
 
+  void releaseMemory() { MBFI = 0; }
+
   /// getblockFreq - Return block frequency. Return 0 if we don't have the
   /// information. Please note that initial frequency is equal to 1024. It means
   /// that we should not rely on the value itself, but only on the comparison to
@@ -40,6 +40,9 @@ typedef DomTreeNodeBase<MachineBasicBlock> MachineDomTreeNode;
 class MachineDominatorTree : public MachineFunctionPass {
 public:
   static char ID; // Pass ID, replacement for typeid
+
+  /// DT - The dominator tree of the current function. It is owned by the
+  /// MachineFunction so that it can be reused while the CFG is unchanged.
   DominatorTreeBase<MachineBasicBlock>* DT;
 
   MachineDominatorTree();
@@ -166,7 +169,7 @@ public:
     return DT->isReachableFromEntry(A);
   }
 
-  virtual void releaseMemory();
+  virtual void releaseMemory() { DT = 0; }
 
   virtual void print(raw_ostream &OS, const Module*) const;
 };
@@ -18,6 +18,7 @@
 #ifndef LLVM_CODEGEN_MACHINEFUNCTION_H
 #define LLVM_CODEGEN_MACHINEFUNCTION_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/ilist.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/Support/Allocator.h"
@@ -72,6 +73,19 @@ struct MachineFunctionInfo {
   virtual ~MachineFunctionInfo();
 };
 
+/// MachineCFGAnalysisResult - Base class for the results of analyses that
+/// depend only on the CFG. The pass manager creates a new analysis instance
+/// each time a result is needed after being invalidated, so the results are
+/// owned by the MachineFunction instead. A new instance can then take over a
+/// result that is still valid. See MachineFunction::getCFGAnalysisResult.
+struct MachineCFGAnalysisResult {
+  /// The CFG version the result was computed for, or 0 if there is none.
+  unsigned CFGVersion;
+
+  MachineCFGAnalysisResult() : CFGVersion(0) {}
+  virtual ~MachineCFGAnalysisResult();
+};
+
 class MachineFunction {
   const Function *Fn;
   const TargetMachine &Target;
@@ -120,6 +134,15 @@ class MachineFunction {
   /// this translation unit.
   ///
   unsigned FunctionNumber;
+
+  /// CFGVersion - Identifies the current shape of the CFG. It changes whenever
+  /// a block is added or removed, or an edge between blocks changes. Versions
+  /// are never reused, even across functions, so an analysis that depends only
+  /// on the CFG can compare versions to tell whether its result is still valid.
+  unsigned CFGVersion;
+
+  /// CFGAnalyses - Results of CFG-only analyses, keyed by pass ID.
+  DenseMap<const void*, MachineCFGAnalysisResult*> CFGAnalyses;
   
   /// Alignment - The alignment of the function.
   unsigned Alignment;
@@ -158,6 +181,25 @@ public:
   ///
   unsigned getFunctionNumber() const { return FunctionNumber; }
 
+  /// getCFGVersion - Return the current CFG version. See CFGVersion.
+  ///
+  unsigned getCFGVersion() const { return CFGVersion; }
+
+  /// invalidateCFG - Assign a new CFG version. MachineBasicBlock calls this
+  /// whenever blocks or edges are added or removed.
+  void invalidateCFG();
+
+  /// getCFGAnalysisResult - Return the result stored for the CFG-only analysis
+  /// with pass ID \p ID, creating an empty one the first time. Check its
+  /// CFGVersion against getCFGVersion() before using it.
+  template<typename ResultT>
+  ResultT &getCFGAnalysisResult(const void *ID) {
+    MachineCFGAnalysisResult *&Result = CFGAnalyses[ID];
+    if (!Result)
+      Result = new ResultT();
+    return *static_cast<ResultT*>(Result);
+  }
+
   /// getTarget - Return the target machine this machine code is compiled with
   ///
   const TargetMachine &getTarget() const { return Target; }
@@ -276,6 +318,10 @@ public:
   ///
   void print(raw_ostream &OS, SlotIndexes* = 0) const;
 
+  /// printMemoryUsage - Print a summary of the memory used by the blocks,
+  /// instructions and operands of this function.
+  void printMemoryUsage(raw_ostream &OS) const;
+
   /// viewCFG - This function is meant for use from the debugger.  You can just
   /// say 'call F->viewCFG()' and a ghostview window should pop up from the
   /// program, displaying the CFG of the current function with the code for each
@@ -335,9 +381,14 @@ public:
     BasicBlocks.insert(MBBI, MBB);
   }
   void splice(iterator InsertPt, iterator MBBI) {
+    // Moving a block into or out of the entry position changes the CFG.
+    if (InsertPt == begin() || MBBI == begin())
+      invalidateCFG();
     BasicBlocks.splice(InsertPt, BasicBlocks, MBBI);
   }
   void splice(iterator InsertPt, iterator MBBI, iterator MBBE) {
+    if (InsertPt == begin() || MBBI == begin())
+      invalidateCFG();
     BasicBlocks.splice(InsertPt, BasicBlocks, MBBI, MBBE);
   }
 
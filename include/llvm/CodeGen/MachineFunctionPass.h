@@ -46,6 +46,13 @@ protected:
   ///
   virtual void getAnalysisUsage(AnalysisUsage &AU) const;
 
+  /// isCFGUnchanged - Analyses that depend only on the CFG can keep their
+  /// result across invalidations and call this at the start of
+  /// runOnMachineFunction with the CFG version the result was computed for.
+  /// It returns true if the CFG of MF is still the same, and reports the reuse
+  /// under -debug-pass=Executions.
+  bool isCFGUnchanged(const MachineFunction &MF, unsigned CFGVersion);
+
 private:
   /// createPrinterPass - Get a machine function printer pass.
   virtual Pass *createPrinterPass(raw_ostream &O,
@@ -264,6 +264,12 @@ public:
   ///
   unsigned getNumOperands() const { return NumOperands; }
 
+  /// getOperandCapacity - Returns the number of operands that fit in the
+  /// currently allocated operand array.
+  unsigned getOperandCapacity() const {
+    return Operands ? CapOperands.getSize() : 0;
+  }
+
   const MachineOperand& getOperand(unsigned i) const {
     assert(i < getNumOperands() && "getOperand() out of range!");
     return Operands[i];
@@ -70,7 +70,9 @@ class LoopInfoBase<MachineBasicBlock, MachineLoop>;
 #endif
 
 class MachineLoopInfo : public MachineFunctionPass {
-  LoopInfoBase<MachineBasicBlock, MachineLoop> LI;
+  /// LI - The loops of the current function. They are owned by the
+  /// MachineFunction so that they can be reused while the CFG is unchanged.
+  LoopInfoBase<MachineBasicBlock, MachineLoop> *LI;
   friend class LoopBase<MachineBasicBlock, MachineLoop>;
 
   void operator=(const MachineLoopInfo &) LLVM_DELETED_FUNCTION;
@@ -79,81 +81,81 @@ class MachineLoopInfo : public MachineFunctionPass {
 public:
   static char ID; // Pass identification, replacement for typeid
 
-  MachineLoopInfo() : MachineFunctionPass(ID) {
+  MachineLoopInfo() : MachineFunctionPass(ID), LI(0) {
     initializeMachineLoopInfoPass(*PassRegistry::getPassRegistry());
   }
 
-  LoopInfoBase<MachineBasicBlock, MachineLoop>& getBase() { return LI; }
+  LoopInfoBase<MachineBasicBlock, MachineLoop>& getBase() { return *LI; }
 
   /// iterator/begin/end - The interface to the top-level loops in the current
   /// function.
   ///
   typedef LoopInfoBase<MachineBasicBlock, MachineLoop>::iterator iterator;
-  inline iterator begin() const { return LI.begin(); }
-  inline iterator end() const { return LI.end(); }
-  bool empty() const { return LI.empty(); }
+  inline iterator begin() const { return LI->begin(); }
+  inline iterator end() const { return LI->end(); }
+  bool empty() const { return LI->empty(); }
 
   /// getLoopFor - Return the inner most loop that BB lives in.  If a basic
   /// block is in no loop (for example the entry node), null is returned.
   ///
   inline MachineLoop *getLoopFor(const MachineBasicBlock *BB) const {
-    return LI.getLoopFor(BB);
+    return LI->getLoopFor(BB);
   }
 
   /// operator[] - same as getLoopFor...
   ///
   inline const MachineLoop *operator[](const MachineBasicBlock *BB) const {
-    return LI.getLoopFor(BB);
+    return LI->getLoopFor(BB);
   }
 
   /// getLoopDepth - Return the loop nesting level of the specified block...
   ///
   inline unsigned getLoopDepth(const MachineBasicBlock *BB) const {
-    return LI.getLoopDepth(BB);
+    return LI->getLoopDepth(BB);
   }
 
   // isLoopHeader - True if the block is a loop header node
   inline bool isLoopHeader(MachineBasicBlock *BB) const {
-    return LI.isLoopHeader(BB);
+    return LI->isLoopHeader(BB);
   }
 
   /// runOnFunction - Calculate the natural loop information.
   ///
   virtual bool runOnMachineFunction(MachineFunction &F);
 
-  virtual void releaseMemory() { LI.releaseMemory(); }
+  virtual void releaseMemory() { LI = 0; }
 
   virtual void getAnalysisUsage(AnalysisUsage &AU) const;
 
   /// removeLoop - This removes the specified top-level loop from this loop info
   /// object.  The loop is not deleted, as it will presumably be inserted into
   /// another loop.
-  inline MachineLoop *removeLoop(iterator I) { return LI.removeLoop(I); }
+  inline MachineLoop *removeLoop(iterator I) { return LI->removeLoop(I); }
 
   /// changeLoopFor - Change the top-level loop that contains BB to the
   /// specified loop.  This should be used by transformations that restructure
   /// the loop hierarchy tree.
   inline void changeLoopFor(MachineBasicBlock *BB, MachineLoop *L) {
-    LI.changeLoopFor(BB, L);
+    LI->changeLoopFor(BB, L);
   }
 
   /// changeTopLevelLoop - Replace the specified loop in the top-level loops
   /// list with the indicated loop.
   inline void changeTopLevelLoop(MachineLoop *OldLoop, MachineLoop *NewLoop) {
-    LI.changeTopLevelLoop(OldLoop, NewLoop);
+    LI->changeTopLevelLoop(OldLoop, NewLoop);
   }
 
   /// addTopLevelLoop - This adds the specified loop to the collection of
   /// top-level loops.
   inline void addTopLevelLoop(MachineLoop *New) {
-    LI.addTopLevelLoop(New);
+    LI->addTopLevelLoop(New);
   }
 
   /// removeBlock - This method completely removes BB from all data structures,
   /// including all of the Loop objects it is nested in and our mapping from
   /// MachineBasicBlocks to loops.
   void removeBlock(MachineBasicBlock *BB) {
-    LI.removeBlock(BB);
+    LI->removeBlock(BB);
   }
 };
 
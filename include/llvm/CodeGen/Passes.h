@@ -345,6 +345,10 @@ namespace llvm {
   createMachineFunctionPrinterPass(raw_ostream &OS,
                                    const std::string &Banner ="");
 
+  /// MachineMemoryReport pass - This pass prints the memory used by each
+  /// machine function to the given stream.
+  MachineFunctionPass *createMachineMemoryReportPass(raw_ostream &OS);
+
   /// MachineLoopInfo - This pass is a loop analysis pass.
   extern char &MachineLoopInfoID;
 
@@ -418,6 +422,13 @@ namespace llvm {
   ///
   FunctionPass *createBasicRegisterAllocator();
 
+  /// LinearScanRegisterAllocation Pass - This pass implements a linear scan
+  /// register allocator without live range splitting.  It is cheaper than the
+  /// greedy allocator.  CodeGenOpt::Less uses it when the target options ask
+  /// for it with UseLinearScanRegAlloc.
+  ///
+  FunctionPass *createLinearScanRegisterAllocator();
+
   /// Greedy register allocation pass - This pass implements a global register
   /// allocator for optimized builds.
   ///
@@ -111,6 +111,10 @@ namespace llvm {
     /// removed once that client is obsolete.
     unsigned EndIndex;
 
+    /// Set by buildSchedGraph when the region is too large for the precise
+    /// memory dependence model.
+    bool IsHugeRegion;
+
     /// After calling BuildSchedGraph, each machine instruction in the current
     /// scheduling region is mapped to an SUnit.
     DenseMap<MachineInstr*, SUnit*> MISUnitMap;
@@ -169,6 +173,12 @@ namespace llvm {
     /// end - Return an iterator to the bottom of the current scheduling region.
     MachineBasicBlock::iterator end() const { return RegionEnd; }
 
+    /// isHugeRegion - Return true if the current region exceeds the
+    /// -sched-huge-region threshold. Its DAG was built with a cheaper memory
+    /// dependence model, and strategies should avoid heuristics that are
+    /// superlinear in the region size.
+    bool isHugeRegion() const { return IsHugeRegion; }
+
     /// newSUnit - Creates a new SUnit and return a ptr to it.
     SUnit *newSUnit(MachineInstr *MI);
 
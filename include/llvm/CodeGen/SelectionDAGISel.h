@@ -236,6 +236,12 @@ public:
                            const unsigned char *MatcherTable,
                            unsigned TableSize);
 
+  /// SelectCodeCommon - Like the above, but start matching at MatcherIndex,
+  /// which tblgen has already looked up for the opcode of NodeToMatch.
+  SDNode *SelectCodeCommon(SDNode *NodeToMatch,
+                           const unsigned char *MatcherTable,
+                           unsigned TableSize, unsigned MatcherIndex);
+
 private:
 
   // Calls to these functions are generated by tblgen.
@@ -279,6 +285,9 @@ private:
   /// state machines that start with a OPC_SwitchOpcode node.
   std::vector<unsigned> OpcodeOffset;
 
+  unsigned getRootMatcherIndex(unsigned Opcode,
+                               const unsigned char *MatcherTable);
+
   void UpdateChainsAndGlue(SDNode *NodeToMatch, SDValue InputChain,
                            const SmallVectorImpl<SDNode*> &ChainNodesMatched,
                            SDValue InputGlue, const SmallVectorImpl<SDNode*> &F,
@@ -341,6 +341,10 @@ private:
   /// NumOperands/NumValues - The number of entries in the Operand/Value list.
   unsigned short NumOperands, NumValues;
 
+  /// CombinerWorklistIndex - The position of this node on the DAG combiner's
+  /// worklist, or -1 if it is not on it.
+  int CombinerWorklistIndex;
+
   /// debugLoc - source line information.
   DebugLoc debugLoc;
 
@@ -412,6 +416,14 @@ public:
   /// setNodeId - Set unique node id.
   void setNodeId(int Id) { NodeId = Id; }
 
+  /// getCombinerWorklistIndex - Return the position of this node on the DAG
+  /// combiner's worklist, or -1 if it is not on it.
+  int getCombinerWorklistIndex() const { return CombinerWorklistIndex; }
+
+  /// setCombinerWorklistIndex - Record the position of this node on the DAG
+  /// combiner's worklist.
+  void setCombinerWorklistIndex(int Index) { CombinerWorklistIndex = Index; }
+
   /// getDebugLoc - Return the source location info.
   const DebugLoc getDebugLoc() const { return debugLoc; }
 
@@ -687,7 +699,7 @@ protected:
       SubclassData(0), NodeId(-1),
       OperandList(NumOps ? new SDUse[NumOps] : 0),
       ValueList(VTs.VTs), UseList(NULL),
-      NumOperands(NumOps), NumValues(VTs.NumVTs),
+      NumOperands(NumOps), NumValues(VTs.NumVTs), CombinerWorklistIndex(-1),
       debugLoc(dl) {
     for (unsigned i = 0; i != NumOps; ++i) {
       OperandList[i].setUser(this);
@@ -702,7 +714,7 @@ protected:
     : NodeType(Opc), OperandsNeedDelete(false), HasDebugValue(false),
       SubclassData(0), NodeId(-1), OperandList(0), ValueList(VTs.VTs),
       UseList(NULL), NumOperands(0), NumValues(VTs.NumVTs),
-      debugLoc(dl) {}
+      CombinerWorklistIndex(-1), debugLoc(dl) {}
 
   /// InitOperands - Initialize the operands list of this with 1 operand.
   void InitOperands(SDUse *Ops, const SDValue &Op0) {
@@ -37,19 +37,19 @@ namespace llvm {
   /// information.
   class IndexListEntry : public ilist_node<IndexListEntry> {
     MachineInstr *mi;
-    unsigned index;
+    uint64_t index;
 
   public:
 
-    IndexListEntry(MachineInstr *mi, unsigned index) : mi(mi), index(index) {}
+    IndexListEntry(MachineInstr *mi, uint64_t index) : mi(mi), index(index) {}
 
     MachineInstr* getInstr() const { return mi; }
     void setInstr(MachineInstr *mi) {
       this->mi = mi;
     }
 
-    unsigned getIndex() const { return index; }
-    void setIndex(unsigned index) {
+    uint64_t getIndex() const { return index; }
+    void setIndex(uint64_t index) {
       this->index = index;
     }
 
@@ -130,10 +130,17 @@ namespace llvm {
       return lie.getPointer();
     }
 
-    unsigned getIndex() const {
+    uint64_t getIndex() const {
       return listEntry()->getIndex() | getSlot();
     }
 
+    /// Returns the index scaled back to InstrDist units per instruction.
+    /// Distances are measured in these units so that heuristics see the same
+    /// numbers however much label space the list entries use.
+    unsigned getScaledIndex() const {
+      return (unsigned(listEntry()->getIndex() >> IndexShift) & ~3u) | getSlot();
+    }
+
     /// Returns the slot for this SlotIndex.
     Slot getSlot() const {
       return static_cast<Slot>(lie.getInt());
@@ -143,7 +150,12 @@ namespace llvm {
     enum {
       /// The default distance between instructions as returned by distance().
       /// This may vary as instructions are inserted and removed.
-      InstrDist = 4 * Slot_Count
+      InstrDist = 4 * Slot_Count,
+
+      /// List entries are labelled with InstrDist << IndexShift between
+      /// instructions.  The extra bits let many instructions be inserted into
+      /// a gap before any entries need to be renumbered.
+      IndexShift = 24
     };
 
     /// Construct an invalid index.
@@ -215,7 +227,7 @@ namespace llvm {
 
     /// Return the distance from this index to the given one.
     int distance(SlotIndex other) const {
-      return other.getIndex() - getIndex();
+      return other.getScaledIndex() - getScaledIndex();
     }
 
     /// isBlock - Returns true if this is a block boundary slot.
@@ -349,7 +361,7 @@ namespace llvm {
     // IndexListEntry allocator.
     BumpPtrAllocator ileAllocator;
 
-    IndexListEntry* createEntry(MachineInstr *mi, unsigned index) {
+    IndexListEntry* createEntry(MachineInstr *mi, uint64_t index) {
       IndexListEntry *entry =
         static_cast<IndexListEntry*>(
           ileAllocator.Allocate(sizeof(IndexListEntry),
@@ -583,8 +595,8 @@ namespace llvm {
 
       // Get a number for the new instr, or 0 if there's no room currently.
       // In the latter case we'll force a renumber later.
-      unsigned dist = ((nextItr->getIndex() - prevItr->getIndex())/2) & ~3u;
-      unsigned newNumber = prevItr->getIndex() + dist;
+      uint64_t dist = ((nextItr->getIndex() - prevItr->getIndex())/2) & ~3ull;
+      uint64_t newNumber = prevItr->getIndex() + dist;
 
       // Insert a new list entry for mi.
       IndexList::iterator newItr =
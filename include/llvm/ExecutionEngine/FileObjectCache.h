@@ -0,0 +1,87 @@
+//===-- FileObjectCache.h - On-disk object cache for MCJIT ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares an ObjectCache which persists compiled objects in a
+// directory so that they can be reused across runs.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_FILEOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_FILEOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CodeGen.h"
+#include <string>
+
+namespace llvm {
+
+/// This is an ObjectCache which stores each compiled object as a file in a
+/// cache directory.
+///
+/// Objects are keyed by a hash of the module's bitcode together with the
+/// target triple, CPU, features and optimization level, so an object is only
+/// reused for an identical module compiled with identical settings.  Cached
+/// objects are read back with MemoryBuffer::getFile, which maps them into
+/// memory where the platform allows it.
+///
+/// Several processes may share a cache directory.  Writers coordinate through
+/// a LockFileManager and install each object with an atomic rename, so
+/// readers never observe a partially written file.  If a maximum size is
+/// given, the least recently written objects are removed whenever the cache
+/// grows beyond it.
+class FileObjectCache : public ObjectCache {
+  FileObjectCache(const FileObjectCache&) LLVM_DELETED_FUNCTION;
+  void operator=(const FileObjectCache&) LLVM_DELETED_FUNCTION;
+
+public:
+  /// \p CPU, \p Features and \p OptLevel should match the settings of the
+  /// engine the cache is attached to.  A \p MaxSize of zero leaves the cache
+  /// unbounded.
+  FileObjectCache(StringRef CacheDir, StringRef CPU = "",
+                  StringRef Features = "",
+                  CodeGenOpt::Level OptLevel = CodeGenOpt::Default,
+                  uint64_t MaxSize = 0);
+  virtual ~FileObjectCache();
+
+  virtual void notifyObjectCompiled(const Module *M, const MemoryBuffer *Obj);
+
+  /// getCachePath - Returns the path of the file that holds, or would hold,
+  /// the object for Module M in its current state.  Code generation changes
+  /// the module, so the path of an object being compiled is the one computed
+  /// by the getObject call that missed.
+  std::string getCachePath(const Module *M) const;
+
+  /// prune - Removes the oldest objects until the cache fits in the maximum
+  /// size.  This is called after every insertion.
+  void prune();
+
+protected:
+  virtual const MemoryBuffer *getObject(const Module *M);
+
+private:
+  std::string CacheDir;
+  std::string CPU;
+  std::string Features;
+  CodeGenOpt::Level OptLevel;
+  uint64_t MaxSize;
+
+  /// Objects read back from disk, keyed by path.  The buffers are owned by
+  /// the cache.
+  StringMap<MemoryBuffer*> LoadedObjects;
+
+  /// Paths computed by getObject for modules that missed in the cache, to be
+  /// used when their objects are written by notifyObjectCompiled.
+  DenseMap<const Module*, std::string> PendingPaths;
+};
+
+}
+
+#endif
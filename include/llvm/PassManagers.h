@@ -104,6 +104,7 @@ enum PassDebuggingString {
   EXECUTION_MSG, // "Executing Pass '"
   MODIFICATION_MSG, // "' Made Modification '"
   FREEING_MSG, // " Freeing Pass '"
+  REUSING_MSG, // " Reusing Pass '"
   ON_BASICBLOCK_MSG, // "'  on BasicBlock '" + PassName + "'...\n"
   ON_FUNCTION_MSG, // "' on Function '" + FunctionName + "'...\n"
   ON_MODULE_MSG, // "' on Module '" + ModuleName + "'...\n"
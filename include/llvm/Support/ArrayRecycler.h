@@ -24,8 +24,10 @@ class BumpPtrAllocator;
 
 /// Recycle small arrays allocated from a BumpPtrAllocator.
 ///
-/// Arrays are allocated in a small number of fixed sizes. For each supported
-/// array size, the ArrayRecycler keeps a free list of available arrays.
+/// Arrays are allocated in a small number of fixed sizes: 1, 2, 3, 4, 6, 8, 12,
+/// 16, ... (the powers of two and the points half way between them).  For each
+/// supported array size, the ArrayRecycler keeps a free list of available
+/// arrays.
 ///
 template<class T, size_t Align = AlignOf<T>::Alignment>
 class ArrayRecycler {
@@ -76,11 +78,23 @@ public:
 
     /// Get the capacity of an array that can hold at least N elements.
     static Capacity get(size_t N) {
-      return Capacity(N ? Log2_64_Ceil(N) : 0);
+      if (N <= 2)
+        return Capacity(N == 2);
+      // Odd indexes are the powers of two, even indexes fall half way between.
+      unsigned K = Log2_64_Ceil(N);
+      if (N <= (size_t(3) << (K - 2)))
+        return Capacity(2 * K - 2);
+      return Capacity(2 * K - 1);
     }
 
     /// Get the number of elements in an array with this capacity.
-    size_t getSize() const { return size_t(1u) << Index; }
+    size_t getSize() const {
+      if (Index == 0)
+        return 1;
+      if (Index & 1)
+        return size_t(1u) << ((Index + 1) / 2);
+      return size_t(3u) << (Index / 2 - 1);
+    }
 
     /// Get the bucket number for this capacity.
     unsigned getBucket() const { return Index; }
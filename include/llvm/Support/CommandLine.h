@@ -50,6 +50,14 @@ void ParseCommandLineOptions(int argc, const char * const *argv,
 void ParseEnvironmentOptions(const char *progName, const char *envvar,
                              const char *Overview = 0);
 
+//===----------------------------------------------------------------------===//
+// ParseCommandLineString - Split Args at whitespace and process the words as
+//                          if they had been given on the command line of
+//                          progName.
+//
+void ParseCommandLineString(const char *progName, StringRef Args,
+                            const char *Overview = 0);
+
 ///===---------------------------------------------------------------------===//
 /// SetVersionPrinter - Override the default (LLVM specific) version printer
 ///                     used to print out the version when --version is given
@@ -76,6 +84,12 @@ void PrintOptionValues();
 // MarkOptionsChanged - Internal helper function.
 void MarkOptionsChanged();
 
+// ResetAllOptionOccurrences - Return every registered option to its initial
+// value and clear its occurrence count, so that ParseCommandLineOptions can be
+// called again for a new set of arguments.  Values a tool assigned to an
+// option directly after parsing are discarded as well.
+void ResetAllOptionOccurrences();
+
 //===----------------------------------------------------------------------===//
 // Flags permitted to be passed to command line arguments
 //
@@ -243,6 +257,15 @@ public:
 
   virtual void getExtraOptionNames(SmallVectorImpl<const char*> &) {}
 
+  // setDefault - Overriden by subclasses to restore the value the option had
+  // before any argument was parsed.
+  //
+  virtual void setDefault() {}
+
+  // reset - Forget all occurrences of this option and restore its default.
+  //
+  void reset();
+
   // addOccurrence - Wrapper around handleOccurrence that enforces Flags.
   //
   bool addOccurrence(unsigned pos, StringRef ArgName,
@@ -1012,6 +1035,21 @@ void apply(const Mod &M, Opt *O) {
   applicator<Mod>::opt(M, *O);
 }
 
+//===----------------------------------------------------------------------===//
+// restoreOptionValue - Copy a saved default back into an option's external
+// storage.  Types that cannot be copied, such as the objects behind action
+// options like -help, have no saved value and are left alone.
+//
+template<class DataType>
+void restoreOptionValue(DataType &Location,
+                        const OptionValueCopy<DataType> &Default) {
+  if (Default.hasValue())
+    Location = Default.getValue();
+}
+
+template<class DataType>
+void restoreOptionValue(DataType &, const GenericOptionValue &) {}
+
 //===----------------------------------------------------------------------===//
 // opt_storage class
 
@@ -1054,6 +1092,11 @@ public:
   operator DataType() const { return this->getValue(); }
 
   const OptionValue<DataType> &getDefault() const { return Default; }
+
+  void restoreDefault() {
+    if (Location)
+      restoreOptionValue(*Location, Default);
+  }
 };
 
 // Define how to hold a class type object, such as a string.  Since we can
@@ -1076,6 +1119,13 @@ public:
   const DataType &getValue() const { return *this; }
 
   const OptionValue<DataType> &getDefault() const { return Default; }
+
+  void restoreDefault() {
+    if (Default.hasValue())
+      setValue(Default.getValue());
+    else
+      setValue(DataType());
+  }
 };
 
 // Define a partial specialization to handle things we cannot inherit from.  In
@@ -1103,6 +1153,8 @@ public:
 
   const OptionValue<DataType> &getDefault() const { return Default; }
 
+  void restoreDefault() { Value = Default.getValue(); }
+
   operator DataType() const { return getValue(); }
 
   // If the datatype is a pointer, support -> on it.
@@ -1151,6 +1203,8 @@ class opt : public Option,
     }
   }
 
+  virtual void setDefault() { this->restoreDefault(); }
+
   void done() {
     addArgument();
     Parser.initialize(*this);
@@ -1267,6 +1321,11 @@ public:
            "line option with external storage!");
     Location->push_back(V);
   }
+
+  void clear() {
+    if (Location)
+      Location->clear();
+  }
 };
 
 
@@ -1318,6 +1377,12 @@ class list : public Option, public list_storage<DataType, Storage> {
   // Unimplemented: list options don't currently store their default value.
   virtual void printOptionValue(size_t /*GlobalWidth*/, bool /*Force*/) const {}
 
+  // The default value of a list is always empty.
+  virtual void setDefault() {
+    Positions.clear();
+    list_storage<DataType, Storage>::clear();
+  }
+
   void done() {
     addArgument();
     Parser.initialize(*this);
@@ -1445,6 +1510,11 @@ public:
     *Location |= Bit(V);
   }
 
+  void clear() {
+    if (Location)
+      *Location = 0;
+  }
+
   unsigned getBits() { return *Location; }
 
   template<class T>
@@ -1475,6 +1545,8 @@ public:
     Bits |=  Bit(V);
   }
 
+  void clear() { Bits = 0; }
+
   unsigned getBits() { return Bits; }
 
   template<class T>
@@ -1520,6 +1592,12 @@ class bits : public Option, public bits_storage<DataType, Storage> {
   // Unimplemented: bits options don't currently store their default values.
   virtual void printOptionValue(size_t /*GlobalWidth*/, bool /*Force*/) const {}
 
+  // The default value of a bit vector is always empty.
+  virtual void setDefault() {
+    Positions.clear();
+    bits_storage<DataType, Storage>::clear();
+  }
+
   void done() {
     addArgument();
     Parser.initialize(*this);
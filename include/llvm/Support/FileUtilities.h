@@ -17,6 +17,8 @@
 
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include <cstdio>
+#include <string>
 
 namespace llvm {
 
@@ -32,6 +34,10 @@ namespace llvm {
                              double AbsTol, double RelTol,
                              std::string *Error = 0);
 
+  /// ReadLine - Read a whole line, without the trailing newline, from Input
+  /// into Line.  Returns false once Input is exhausted and nothing was read.
+  ///
+  bool ReadLine(FILE *Input, std::string &Line);
 
   /// FileRemover - This class is a simple object meant to be stack allocated.
   /// If an exception is thrown from a region, the object removes the filename
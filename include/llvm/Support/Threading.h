@@ -54,6 +54,23 @@ namespace llvm {
   /// the thread stack.
   void llvm_execute_on_thread(void (*UserFn)(void*), void *UserData,
                               unsigned RequestedStackSize = 0);
+
+  /// llvm_execute_on_threads - Execute the given \p UserFn once for each of
+  /// the \p NumThreads entries of \p UserData, concurrently on separate
+  /// threads, and wait for all of them to finish.
+  ///
+  /// Where threads are not available the calls are made one after the other
+  /// on the calling thread.  If a thread cannot be created, its call is made
+  /// on the calling thread once the other threads have been started.
+  ///
+  /// \param UserFn - The callback to execute.
+  /// \param UserData - The arguments, one per thread.
+  /// \param NumThreads - The number of entries in \p UserData.
+  /// \param RequestedStackSize - If non-zero, a requested size (in bytes) for
+  /// the thread stacks.
+  void llvm_execute_on_threads(void (*UserFn)(void*), void **UserData,
+                               unsigned NumThreads,
+                               unsigned RequestedStackSize = 0);
 }
 
 #endif
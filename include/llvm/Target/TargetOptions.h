@@ -49,8 +49,9 @@ namespace llvm {
           JITEmitDebugInfo(false), JITEmitDebugInfoToDisk(false),
           GuaranteedTailCallOpt(false), DisableTailCalls(false),
           StackAlignmentOverride(0), RealignStack(true), SSPBufferSize(0),
-          EnableFastISel(false), PositionIndependentExecutable(false),
-          EnableSegmentedStacks(false), UseInitArray(false), TrapFuncName(""),
+          EnableFastISel(false), UseLinearScanRegAlloc(false),
+          PositionIndependentExecutable(false), EnableSegmentedStacks(false),
+          UseInitArray(false), TrapFuncName(""),
           FloatABIType(FloatABI::Default), AllowFPOpFusion(FPOpFusion::Standard)
     {}
 
@@ -164,6 +165,12 @@ namespace llvm {
     /// compile time.
     unsigned EnableFastISel : 1;
 
+    /// UseLinearScanRegAlloc - This flag makes CodeGenOpt::Less use the
+    /// linear scan register allocator instead of the greedy one, unless
+    /// -regalloc says otherwise.  It allocates registers much faster at some
+    /// cost in code quality, which suits JIT compilers that want code quickly.
+    unsigned UseLinearScanRegAlloc : 1;
+
     /// PositionIndependentExecutable - This flag indicates whether the code
     /// will eventually be linked into a single executable, despite the PIC
     /// relocation model being in use. It's value is undefined (and irrelevant)
@@ -17,12 +17,14 @@
 #ifndef LLVM_TRANSFORMS_IPO_INLINERPASS_H
 #define LLVM_TRANSFORMS_IPO_INLINERPASS_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
 
 namespace llvm {
   class CallSite;
   class DataLayout;
   class InlineCost;
+  class Instruction;
   template<class PtrType, unsigned SmallSize>
   class SmallPtrSet;
 
@@ -81,6 +83,20 @@ private:
   // InsertLifetime - Insert @llvm.lifetime intrinsics.
   bool InsertLifetime;
 
+  /// SecondaryCost - The parts of an InlineCost that shouldInline looks at
+  /// when it weighs inlining a caller into its own callers.
+  struct SecondaryCost {
+    bool Inlinable;
+    bool Always;
+    int Cost;
+    int CostDelta;
+  };
+
+  /// SecondaryCosts - Costs computed by shouldInline for the call sites of a
+  /// caller, keyed by call instruction.  They only depend on the IR, so they
+  /// are reused until runOnSCC next changes it.
+  DenseMap<Instruction*, SecondaryCost> SecondaryCosts;
+
   /// shouldInline - Return true if the inliner should attempt to
   /// inline at the given CallSite.
   bool shouldInline(CallSite CS);
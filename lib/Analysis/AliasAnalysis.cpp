@@ -24,7 +24,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#define DEBUG_TYPE "aa"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/CaptureTracking.h"
 #include "llvm/Analysis/Dominators.h"
 #include "llvm/Analysis/ValueTracking.h"
@@ -39,6 +41,9 @@
 #include "llvm/Target/TargetLibraryInfo.h"
 using namespace llvm;
 
+STATISTIC(NumAliasCacheHits, "Number of alias queries answered by a cache");
+STATISTIC(NumAliasCacheMisses, "Number of alias queries missing a cache");
+
 // Register the AliasAnalysis interface, providing a nice name to refer to.
 INITIALIZE_ANALYSIS_GROUP(AliasAnalysis, "Alias Analysis", NoAA)
 char AliasAnalysis::ID = 0;
@@ -53,6 +58,14 @@ AliasAnalysis::alias(const Location &LocA, const Location &LocB) {
   return AA->alias(LocA, LocB);
 }
 
+void AliasAnalysis::aliasBatch(const Location &LocA, ArrayRef<Location> Others,
+                               SmallVectorImpl<AliasResult> &Results) {
+  // Ask this implementation, not the next one in the chain, so that its own
+  // alias() gets to answer each pair.
+  for (unsigned i = 0, e = Others.size(); i != e; ++i)
+    Results.push_back(alias(LocA, Others[i]));
+}
+
 bool AliasAnalysis::pointsToConstantMemory(const Location &Loc,
                                            bool OrLocal) {
   assert(AA && "AA didn't call InitializeAliasAnalysis in its run method!");
@@ -555,3 +568,52 @@ bool llvm::isIdentifiedObject(const Value *V) {
     return A->hasNoAliasAttr() || A->hasByValAttr();
   return false;
 }
+
+//===----------------------------------------------------------------------===//
+// AliasQueryCache implementation
+//===----------------------------------------------------------------------===//
+
+AliasAnalysis::AliasResult
+AliasQueryCache::alias(const AliasAnalysis::Location &LocA,
+                       const AliasAnalysis::Location &LocB) {
+  DenseMap<LocPair, AliasAnalysis::AliasResult>::iterator I =
+    Cache.find(LocPair(LocA, LocB));
+  if (I != Cache.end()) {
+    ++NumAliasCacheHits;
+    return I->second;
+  }
+  ++NumAliasCacheMisses;
+  AliasAnalysis::AliasResult R = AA->alias(LocA, LocB);
+  Cache[LocPair(LocA, LocB)] = R;
+  return R;
+}
+
+void AliasQueryCache::aliasBatch(const AliasAnalysis::Location &LocA,
+                                 ArrayRef<AliasAnalysis::Location> Others,
+                          SmallVectorImpl<AliasAnalysis::AliasResult> &Results) {
+  // Answer what we can from the cache, leaving a placeholder for the rest.
+  SmallVector<AliasAnalysis::Location, 16> Missing;
+  SmallVector<unsigned, 16> MissingIdx;
+  for (unsigned i = 0, e = Others.size(); i != e; ++i) {
+    DenseMap<LocPair, AliasAnalysis::AliasResult>::iterator I =
+      Cache.find(LocPair(LocA, Others[i]));
+    if (I != Cache.end()) {
+      ++NumAliasCacheHits;
+      Results.push_back(I->second);
+    } else {
+      ++NumAliasCacheMisses;
+      Missing.push_back(Others[i]);
+      MissingIdx.push_back(Results.size());
+      Results.push_back(AliasAnalysis::MayAlias);
+    }
+  }
+  if (Missing.empty())
+    return;
+
+  SmallVector<AliasAnalysis::AliasResult, 16> Answers;
+  AA->aliasBatch(LocA, Missing, Answers);
+  for (unsigned i = 0, e = Missing.size(); i != e; ++i) {
+    Results[MissingIdx[i]] = Answers[i];
+    Cache[LocPair(LocA, Missing[i])] = Answers[i];
+  }
+}
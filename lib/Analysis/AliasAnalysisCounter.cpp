@@ -14,6 +14,7 @@
 
 #include "llvm/Analysis/Passes.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/Assembly/Writer.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
@@ -31,6 +32,10 @@ namespace {
   class AliasAnalysisCounter : public ModulePass, public AliasAnalysis {
     unsigned No, May, Partial, Must;
     unsigned NoMR, JustRef, JustMod, MR;
+    // Alias queries that asked about a pair of locations seen before, which an
+    // AliasQueryCache would have answered.
+    unsigned Repeated;
+    DenseSet<std::pair<Location, Location> > SeenQueries;
     Module *M;
   public:
     static char ID; // Class identification, replacement for typeinfo
@@ -38,6 +43,7 @@ namespace {
       initializeAliasAnalysisCounterPass(*PassRegistry::getPassRegistry());
       No = May = Partial = Must = 0;
       NoMR = JustRef = JustMod = MR = 0;
+      Repeated = 0;
     }
 
     void printLine(const char *Desc, unsigned Val, unsigned Sum) {
@@ -59,7 +65,9 @@ namespace {
           errs() << "  Alias Analysis Counter Summary: " << No*100/AASum << "%/"
                  << May*100/AASum << "%/"
                  << Partial*100/AASum << "%/"
-                 << Must*100/AASum<<"%\n\n";
+                 << Must*100/AASum<<"%\n";
+          errs() << "  " << Repeated << " repeated alias queries ("
+                 << Repeated*100/AASum << "%)\n\n";
         }
 
         errs() << "  " << MRSum    << " Total Mod/Ref Queries Performed\n";
@@ -127,6 +135,9 @@ AliasAnalysis::AliasResult
 AliasAnalysisCounter::alias(const Location &LocA, const Location &LocB) {
   AliasResult R = getAnalysis<AliasAnalysis>().alias(LocA, LocB);
 
+  if (!SeenQueries.insert(std::make_pair(LocA, LocB)).second)
+    ++Repeated;
+
   const char *AliasString = 0;
   switch (R) {
   case NoAlias:   No++;   AliasString = "No alias"; break;
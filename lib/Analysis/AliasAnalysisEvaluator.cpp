@@ -184,31 +184,39 @@ bool AAEval::runOnFunction(Function &F) {
     errs() << "Function: " << F.getName() << ": " << Pointers.size()
            << " pointers, " << CallSites.size() << " call sites\n";
 
-  // iterate over the worklist, and run the full (n^2)/2 disambiguations
-  for (SetVector<Value *>::iterator I1 = Pointers.begin(), E = Pointers.end();
-       I1 != E; ++I1) {
-    uint64_t I1Size = AliasAnalysis::UnknownSize;
-    Type *I1ElTy = cast<PointerType>((*I1)->getType())->getElementType();
-    if (I1ElTy->isSized()) I1Size = AA.getTypeStoreSize(I1ElTy);
-
-    for (SetVector<Value *>::iterator I2 = Pointers.begin(); I2 != I1; ++I2) {
-      uint64_t I2Size = AliasAnalysis::UnknownSize;
-      Type *I2ElTy =cast<PointerType>((*I2)->getType())->getElementType();
-      if (I2ElTy->isSized()) I2Size = AA.getTypeStoreSize(I2ElTy);
-
-      switch (AA.alias(*I1, I1Size, *I2, I2Size)) {
+  // Compute the location accessed through each pointer once.
+  SmallVector<AliasAnalysis::Location, 32> Locs;
+  for (SetVector<Value *>::iterator I = Pointers.begin(), E = Pointers.end();
+       I != E; ++I) {
+    uint64_t Size = AliasAnalysis::UnknownSize;
+    Type *ElTy = cast<PointerType>((*I)->getType())->getElementType();
+    if (ElTy->isSized()) Size = AA.getTypeStoreSize(ElTy);
+    Locs.push_back(AliasAnalysis::Location(*I, Size));
+  }
+
+  // iterate over the worklist, and run the full (n^2)/2 disambiguations,
+  // querying each pointer against all of the earlier ones in one batch.
+  SmallVector<AliasAnalysis::AliasResult, 32> Results;
+  for (unsigned i1 = 0, e = Locs.size(); i1 != e; ++i1) {
+    Results.clear();
+    AA.aliasBatch(Locs[i1], makeArrayRef(Locs.data(), i1), Results);
+
+    Value *V1 = Pointers[i1];
+    for (unsigned i2 = 0; i2 != i1; ++i2) {
+      Value *V2 = Pointers[i2];
+      switch (Results[i2]) {
       case AliasAnalysis::NoAlias:
-        PrintResults("NoAlias", PrintNoAlias, *I1, *I2, F.getParent());
+        PrintResults("NoAlias", PrintNoAlias, V1, V2, F.getParent());
         ++NoAlias; break;
       case AliasAnalysis::MayAlias:
-        PrintResults("MayAlias", PrintMayAlias, *I1, *I2, F.getParent());
+        PrintResults("MayAlias", PrintMayAlias, V1, V2, F.getParent());
         ++MayAlias; break;
       case AliasAnalysis::PartialAlias:
-        PrintResults("PartialAlias", PrintPartialAlias, *I1, *I2,
+        PrintResults("PartialAlias", PrintPartialAlias, V1, V2,
                      F.getParent());
         ++PartialAlias; break;
       case AliasAnalysis::MustAlias:
-        PrintResults("MustAlias", PrintMustAlias, *I1, *I2, F.getParent());
+        PrintResults("MustAlias", PrintMustAlias, V1, V2, F.getParent());
         ++MustAlias; break;
       }
     }
@@ -29,10 +29,15 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/PredIteratorCache.h"
+#include <algorithm>
 using namespace llvm;
 
+STATISTIC(NumCacheLocal, "Number of cached local responses");
+STATISTIC(NumUncacheLocal, "Number of uncached or dirty local responses");
+
 STATISTIC(NumCacheNonLocal, "Number of fully cached non-local responses");
 STATISTIC(NumCacheDirtyNonLocal, "Number of dirty cached non-local responses");
 STATISTIC(NumUncacheNonLocal, "Number of uncached non-local responses");
@@ -45,9 +50,33 @@ STATISTIC(NumUncacheNonLocalPtr,
           "Number of uncached non-local ptr responses");
 STATISTIC(NumCacheCompleteNonLocalPtr,
           "Number of block queries that were completely cached");
+STATISTIC(NumEvictNonLocalPtr,
+          "Number of non-local ptr responses evicted from the cache");
 
 // Limit for the number of instructions to scan in a block.
-static const int BlockScanLimit = 100;
+static cl::opt<unsigned>
+BlockScanLimit("memdep-block-scan-limit", cl::Hidden, cl::init(100),
+  cl::desc("The number of instructions to scan in a block in memory "
+           "dependency analysis (default = 100)"));
+
+// Functions with more instructions than this use LargeFunctionScanLimit.
+static cl::opt<unsigned>
+LargeFunctionSize("memdep-large-function-size", cl::Hidden, cl::init(0),
+  cl::desc("Use -memdep-large-function-scan-limit in functions with more "
+           "instructions than this (default = 0, never)"));
+
+static cl::opt<unsigned>
+LargeFunctionScanLimit("memdep-large-function-scan-limit", cl::Hidden,
+  cl::init(25),
+  cl::desc("The number of instructions to scan in a block of a large "
+           "function (default = 25)"));
+
+// The cached non-local pointer results are trimmed back to half this many
+// block entries whenever they grow past it.
+static cl::opt<unsigned>
+NonLocalPtrCacheLimit("memdep-cache-entries", cl::Hidden, cl::init(1000000),
+  cl::desc("The number of cached non-local pointer dependencies to keep "
+           "in memory dependency analysis (0 = unlimited)"));
 
 char MemoryDependenceAnalysis::ID = 0;
 
@@ -59,7 +88,8 @@ INITIALIZE_PASS_END(MemoryDependenceAnalysis, "memdep",
                       "Memory Dependence Analysis", false, true)
 
 MemoryDependenceAnalysis::MemoryDependenceAnalysis()
-: FunctionPass(ID), PredCache(0) {
+: FunctionPass(ID), NumNonLocalPtrQueries(0), NumNonLocalPtrEntries(0),
+  PredCache(0), ScanLimit(BlockScanLimit) {
   initializeMemoryDependenceAnalysisPass(*PassRegistry::getPassRegistry());
 }
 MemoryDependenceAnalysis::~MemoryDependenceAnalysis() {
@@ -74,6 +104,8 @@ void MemoryDependenceAnalysis::releaseMemory() {
   ReverseNonLocalDeps.clear();
   ReverseNonLocalPtrDeps.clear();
   PredCache->clear();
+  NumNonLocalPtrQueries = 0;
+  NumNonLocalPtrEntries = 0;
 }
 
 
@@ -85,12 +117,21 @@ void MemoryDependenceAnalysis::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequiredTransitive<AliasAnalysis>();
 }
 
-bool MemoryDependenceAnalysis::runOnFunction(Function &) {
+bool MemoryDependenceAnalysis::runOnFunction(Function &F) {
   AA = &getAnalysis<AliasAnalysis>();
   TD = getAnalysisIfAvailable<DataLayout>();
   DT = getAnalysisIfAvailable<DominatorTree>();
   if (PredCache == 0)
     PredCache.reset(new PredIteratorCache());
+
+  ScanLimit = BlockScanLimit;
+  if (LargeFunctionSize) {
+    unsigned NumInsts = 0;
+    for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+      NumInsts += I->size();
+    if (NumInsts > LargeFunctionSize)
+      ScanLimit = std::min(ScanLimit, unsigned(LargeFunctionScanLimit));
+  }
   return false;
 }
 
@@ -191,7 +232,7 @@ AliasAnalysis::ModRefResult GetLocation(const Instruction *Inst,
 MemDepResult MemoryDependenceAnalysis::
 getCallSiteDependencyFrom(CallSite CS, bool isReadOnlyCall,
                           BasicBlock::iterator ScanIt, BasicBlock *BB) {
-  unsigned Limit = BlockScanLimit;
+  unsigned Limit = ScanLimit;
 
   // Walk backwards through the block, looking for dependencies
   while (ScanIt != BB->begin()) {
@@ -361,7 +402,7 @@ getPointerDependencyFrom(const AliasAnalysis::Location &MemLoc, bool isLoad,
 
   const Value *MemLocBase = 0;
   int64_t MemLocOffset = 0;
-  unsigned Limit = BlockScanLimit;
+  unsigned Limit = ScanLimit;
   bool isInvariantLoad = false;
   if (isLoad && QueryInst) {
     LoadInst *LI = dyn_cast<LoadInst>(QueryInst);
@@ -550,8 +591,11 @@ MemDepResult MemoryDependenceAnalysis::getDependency(Instruction *QueryInst) {
 
   // If the cached entry is non-dirty, just return it.  Note that this depends
   // on MemDepResult's default constructing to 'dirty'.
-  if (!LocalCache.isDirty())
+  if (!LocalCache.isDirty()) {
+    ++NumCacheLocal;
     return LocalCache;
+  }
+  ++NumUncacheLocal;
 
   // Otherwise, if we have a dirty entry, we know we can start the scan at that
   // instruction, which may save us some work.
@@ -770,6 +814,10 @@ getNonLocalPointerDependency(const AliasAnalysis::Location &Loc, bool isLoad,
          "Can't get pointer deps of a non-pointer!");
   Result.clear();
 
+  ++NumNonLocalPtrQueries;
+  if (NonLocalPtrCacheLimit && NumNonLocalPtrEntries > NonLocalPtrCacheLimit)
+    shrinkNonLocalPointerCache();
+
   PHITransAddr Address(const_cast<Value *>(Loc.Ptr), TD);
 
   // This is the set of blocks we've inspected, and the pointer we consider in
@@ -838,8 +886,10 @@ GetNonLocalInfoForBlock(const AliasAnalysis::Location &Loc,
   // a new entry.
   if (ExistingResult)
     ExistingResult->setResult(Dep);
-  else
+  else {
     Cache->push_back(NonLocalDepEntry(BB, Dep));
+    ++NumNonLocalPtrEntries;
+  }
 
   // If the block has a dependency (i.e. it isn't completely transparent to
   // the value), remember the reverse association because we just added it
@@ -928,6 +978,7 @@ getNonLocalPointerDepFromBB(const PHITransAddr &Pointer,
   std::pair<CachedNonLocalPointerInfo::iterator, bool> Pair =
     NonLocalPointerDeps.insert(std::make_pair(CacheKey, InitialNLPI));
   NonLocalPointerInfo *CacheInfo = &Pair.first->second;
+  CacheInfo->LastQuery = NumNonLocalPtrQueries;
 
   // If we already have a cache entry for this CacheKey, we may need to do some
   // work to reconcile the cache entry and the current query.
@@ -1271,6 +1322,54 @@ RemoveCachedNonLocalPointerDependencies(ValueIsLoadPair P) {
   NonLocalPointerDeps.erase(It);
 }
 
+/// shrinkNonLocalPointerCache - Evict the least recently used entries of
+/// NonLocalPointerDeps until it fits in half the cache budget.  This must only
+/// be called between top-level queries, since the queries hold pointers into
+/// NonLocalPointerDeps.
+void MemoryDependenceAnalysis::shrinkNonLocalPointerCache() {
+  // Entries are only counted as they are added, so get the exact size first.
+  std::vector<std::pair<unsigned, unsigned> > LRU;
+  LRU.reserve(NonLocalPointerDeps.size());
+  unsigned NumEntries = 0;
+  for (CachedNonLocalPointerInfo::iterator I = NonLocalPointerDeps.begin(),
+       E = NonLocalPointerDeps.end(); I != E; ++I) {
+    unsigned Size = I->second.NonLocalDeps.size();
+    LRU.push_back(std::make_pair(I->second.LastQuery, Size));
+    NumEntries += Size;
+  }
+  NumNonLocalPtrEntries = NumEntries;
+  if (NumEntries <= NonLocalPtrCacheLimit)
+    return;
+
+  // Find the last query whose keys have to go. Keys last used by the same
+  // query are evicted together, so the result does not depend on the order of
+  // the map.
+  std::sort(LRU.begin(), LRU.end());
+  unsigned Target = NonLocalPtrCacheLimit / 2;
+  unsigned Cutoff = 0;
+  for (unsigned i = 0, e = LRU.size(); i != e && NumEntries > Target; ++i) {
+    Cutoff = LRU[i].first;
+    NumEntries -= LRU[i].second;
+  }
+
+  SmallVector<ValueIsLoadPair, 64> Evict;
+  for (CachedNonLocalPointerInfo::iterator I = NonLocalPointerDeps.begin(),
+       E = NonLocalPointerDeps.end(); I != E; ++I)
+    if (I->second.LastQuery <= Cutoff)
+      Evict.push_back(I->first);
+
+  NumEntries = NumNonLocalPtrEntries;
+  for (unsigned i = 0, e = Evict.size(); i != e; ++i) {
+    unsigned Size = NonLocalPointerDeps[Evict[i]].NonLocalDeps.size();
+    RemoveCachedNonLocalPointerDependencies(Evict[i]);
+    NumEntries -= Size;
+    NumEvictNonLocalPtr += Size;
+  }
+  DEBUG(dbgs() << "MemDep: evicted " << NumNonLocalPtrEntries - NumEntries
+               << " cached non-local ptr entries\n");
+  NumNonLocalPtrEntries = NumEntries;
+}
+
 
 /// invalidateCachedPointerInfo - This method is used to invalidate cached
 /// information about the specified pointer, because it may be too
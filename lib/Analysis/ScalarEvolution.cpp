@@ -82,6 +82,7 @@
 #include "llvm/Support/ConstantRange.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/GetElementPtrTypeIterator.h"
 #include "llvm/Support/InstIterator.h"
 #include "llvm/Support/MathExtras.h"
@@ -98,6 +99,8 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumTooComplexExprs,
+          "Number of expressions replaced by unknowns for being too complex");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -106,6 +109,17 @@ MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
                                  "derived loop"),
                         cl::init(100));
 
+static cl::opt<unsigned>
+MaxExprSize("scalar-evolution-max-expr-size", cl::Hidden,
+            cl::desc("Maximum number of nodes in the expression for a "
+                     "value before it is treated as unknown (0 = no limit)"),
+            cl::init(1000));
+
+static cl::opt<bool>
+SCEVStats("scev-stats", cl::Hidden,
+          cl::desc("Print the number of SCEV nodes of each kind when "
+                   "ScalarEvolution releases a function"));
+
 // FIXME: Enable this with XDEBUG when the test suite is clean.
 static cl::opt<bool>
 VerifySCEV("verify-scev",
@@ -2724,6 +2738,14 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
   if (I != ValueExprMap.end()) return I->second;
   const SCEV *S = createSCEV(V);
 
+  // Stop a huge expression here rather than let every user of V build on it.
+  // PHIs are left alone, since createNodeForPHI has already recorded their
+  // expression in ValueExprMap.
+  if (!isa<PHINode>(V) && isTooComplex(S)) {
+    ++NumTooComplexExprs;
+    S = getUnknown(V);
+  }
+
   // The process of creating a SCEV for V may have caused other SCEVs
   // to have been created, so it's necessary to insert the new entry
   // from scratch, rather than trying to remember the insert position
@@ -4111,6 +4133,19 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   return BackedgeTakenCounts.find(L)->second = Result;
 }
 
+/// compactIfSparse - DenseMap never shrinks when entries are erased. Rebuild
+/// Map when most of its buckets are unused, so that forgetting a large loop
+/// actually frees memory.
+template<typename MapT>
+static void compactIfSparse(MapT &Map) {
+  const size_t EntrySize = sizeof(typename MapT::value_type);
+  if (Map.getMemorySize() > 64 * EntrySize &&
+      Map.size() * EntrySize * 8 < Map.getMemorySize()) {
+    MapT Compact(Map.begin(), Map.end());
+    Map.swap(Compact);
+  }
+}
+
 /// forgetLoop - This method should be called by the client when it has
 /// changed a loop in a way that may effect ScalarEvolution's ability to
 /// compute a trip count, or if the loop is deleted.
@@ -4148,6 +4183,10 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
   // ValuesAtScopes map.
   for (Loop::iterator I = L->begin(), E = L->end(); I != E; ++I)
     forgetLoop(*I);
+
+  // Give back the buckets of the entries dropped above.
+  compactIfSparse(ValueExprMap);
+  compactIfSparse(ValuesAtScopes);
 }
 
 /// forgetValue - This method should be called by the client when it has
@@ -6625,6 +6664,9 @@ bool ScalarEvolution::runOnFunction(Function &F) {
 }
 
 void ScalarEvolution::releaseMemory() {
+  if (SCEVStats && !UniqueSCEVs.empty())
+    printStatistics(errs());
+
   // Iterate through all the SCEVUnknown instances and call their
   // destructors, so that they release their references to their values.
   for (SCEVUnknown *U = FirstUnknown; U; U = U->Next)
@@ -6953,6 +6995,54 @@ bool ScalarEvolution::hasOperand(const SCEV *S, const SCEV *Op) const {
   return Search.IsFound;
 }
 
+namespace {
+// Count the nodes of an expression, giving up once there are more than Limit.
+// Implements SCEVTraversal::Visitor.
+struct SCEVSizeCounter {
+  unsigned Limit;
+  unsigned Size;
+
+  SCEVSizeCounter(unsigned L): Limit(L), Size(0) {}
+
+  bool follow(const SCEV *S) {
+    ++Size;
+    return !isDone();
+  }
+  bool isDone() const { return Size > Limit; }
+};
+}
+
+bool ScalarEvolution::isTooComplex(const SCEV *S) const {
+  if (MaxExprSize == 0 || isa<SCEVConstant>(S) || isa<SCEVUnknown>(S))
+    return false;
+  SCEVSizeCounter Counter(MaxExprSize);
+  visitAll(S, Counter);
+  return Counter.isDone();
+}
+
+void ScalarEvolution::printStatistics(raw_ostream &OS) const {
+  unsigned Counts[scCouldNotCompute] = { 0 };
+  for (FoldingSet<SCEV>::const_iterator I = UniqueSCEVs.begin(),
+       E = UniqueSCEVs.end(); I != E; ++I)
+    ++Counts[I->getSCEVType()];
+
+  static const char *const Names[scCouldNotCompute] = {
+    "constant", "truncate", "zext", "sext", "add", "mul", "udiv", "addrec",
+    "umax", "smax", "unknown"
+  };
+  OS << "ScalarEvolution statistics for '" << F->getName() << "':\n";
+  for (unsigned i = 0; i != scCouldNotCompute; ++i)
+    OS << format("%10u", Counts[i]) << " " << Names[i] << " nodes\n";
+  OS << format("%10u", (unsigned)SCEVAllocator.getTotalMemory())
+     << " bytes allocated for nodes\n";
+  OS << format("%10u", ValueExprMap.size()) << " values\n";
+  OS << format("%10u", BackedgeTakenCounts.size())
+     << " backedge-taken counts\n";
+  OS << format("%10u", ConstantEvolutionLoopExitValue.size())
+     << " constant exit values\n";
+  OS << format("%10u", ValuesAtScopes.size()) << " values at scopes\n";
+}
+
 void ScalarEvolution::forgetMemoizedResults(const SCEV *S) {
   ValuesAtScopes.erase(S);
   LoopDispositions.erase(S);
@@ -16,12 +16,14 @@
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/OperandTraits.h"
 #include "llvm/IR/Operator.h"
 #include "llvm/Support/DataStream.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 using namespace llvm;
 
 enum {
@@ -1469,6 +1471,60 @@ bool BitcodeReader::RememberAndSkipFunctionBody() {
   return false;
 }
 
+/// ParseFunctionIndex - Read the positions of all function bodies from the
+/// function index block, and the position just past the last body into
+/// EndOfBodies.  The bodies can then be materialized by seeking straight to
+/// them, without visiting the blocks in between.
+bool BitcodeReader::ParseFunctionIndex(uint64_t &EndOfBodies) {
+  if (Stream.EnterSubBlock(bitc::FUNCTION_INDEX_BLOCK_ID))
+    return Error("Malformed block record");
+
+  SmallVector<uint64_t, 1> Record;
+  StringRef Blob;
+  bool SeenOffsets = false;
+  while (1) {
+    BitstreamEntry Entry = Stream.advanceSkippingSubblocks();
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::SubBlock: // Handled for us already.
+    case BitstreamEntry::Error:
+      return Error("malformed function index block");
+    case BitstreamEntry::EndBlock:
+      if (SeenOffsets) {
+        SeenFunctionIndex = true;
+        std::vector<Function*>().swap(FunctionsWithBodies);
+      }
+      return false;
+    case BitstreamEntry::Record:
+      // The interesting case.
+      break;
+    }
+
+    Record.clear();
+    if (Stream.readRecord(Entry.ID, Record, &Blob) !=
+        bitc::FUNC_INDEX_CODE_OFFSETS)
+      continue;
+
+    // OFFSETS: [blob of (#bodies + 1) x uint64]
+    if (Blob.size() != (FunctionsWithBodies.size() + 1) * 8)
+      return Error("Function index does not match function protos");
+    const unsigned char *Data =
+      reinterpret_cast<const unsigned char *>(Blob.data());
+    for (unsigned i = 0, e = FunctionsWithBodies.size() + 1; i != e; ++i) {
+      uint64_t Offset = 0;
+      for (unsigned Byte = 0; Byte != 8; ++Byte)
+        Offset |= uint64_t(Data[i * 8 + Byte]) << (Byte * 8);
+      if (!Stream.canSkipToPos(Offset / 8))
+        return Error("Function index offset out of range");
+      if (i == e - 1)
+        EndOfBodies = Offset;
+      else
+        DeferredFunctionInfo[FunctionsWithBodies[i]] = Offset;
+    }
+    SeenOffsets = true;
+  }
+}
+
 bool BitcodeReader::GlobalCleanup() {
   // Patch the initializers for globals and aliases up.
   ResolveGlobalAndAliasInits();
@@ -1551,7 +1607,32 @@ bool BitcodeReader::ParseModule(bool Resume) {
         if (ParseMetadata())
           return true;
         break;
+      case bitc::FUNCTION_INDEX_BLOCK_ID:
+        // The index is only of use when we can seek; a streaming reader
+        // would have to fetch everything up to the bodies anyway.
+        if (LazyStreamer || SeenFirstFunctionBody) {
+          if (Stream.SkipBlock())
+            return Error("Malformed block record");
+          break;
+        }
+        uint64_t EndOfBodies;
+        if (ParseFunctionIndex(EndOfBodies))
+          return true;
+        if (SeenFunctionIndex) {
+          // All the bodies are known, so skip over them without looking.
+          if (GlobalCleanup())
+            return true;
+          SeenFirstFunctionBody = true;
+          Stream.JumpToBit(EndOfBodies);
+        }
+        break;
       case bitc::FUNCTION_BLOCK_ID:
+        // The function index has told us where all the bodies are.
+        if (SeenFunctionIndex) {
+          if (Stream.SkipBlock())
+            return Error("Malformed block record");
+          break;
+        }
         // If this is the first function body we've seen, reverse the
         // FunctionsWithBodies list.
         if (!SeenFirstFunctionBody) {
@@ -2935,6 +3016,36 @@ void BitcodeReader::Dematerialize(GlobalValue *GV) {
 }
 
 
+namespace {
+struct BodyOffsetLess {
+  bool operator()(const std::pair<Function*, uint64_t> &LHS,
+                  const std::pair<Function*, uint64_t> &RHS) const {
+    return LHS.second < RHS.second;
+  }
+};
+}
+
+void BitcodeReader::getDeferredFunctionBodies(
+                  std::vector<std::pair<Function*, uint64_t> > &Bodies) const {
+  assert(!LazyStreamer && "Body sizes are unknown while streaming");
+  Bodies.clear();
+  for (DenseMap<Function*, uint64_t>::const_iterator
+       I = DeferredFunctionInfo.begin(), E = DeferredFunctionInfo.end();
+       I != E; ++I)
+    if (I->first->isMaterializable())
+      Bodies.push_back(*I);
+  std::sort(Bodies.begin(), Bodies.end(), BodyOffsetLess());
+
+  // Turn the start offsets into sizes.  The last body extends up to the end
+  // of the module block, which is close enough to the end of the stream.
+  uint64_t EndBit = StreamFile->getBitcodeBytes().getExtent() * 8;
+  for (unsigned i = Bodies.size(); i != 0; --i) {
+    uint64_t StartBit = Bodies[i - 1].second;
+    Bodies[i - 1].second = EndBit > StartBit ? EndBit - StartBit : 0;
+    EndBit = StartBit;
+  }
+}
+
 bool BitcodeReader::MaterializeModule(Module *M, std::string *ErrInfo) {
   assert(M == TheModule &&
          "Can only Materialize the Module this BitcodeReader is attached to.");
@@ -3094,6 +3205,95 @@ Module *llvm::ParseBitcodeFile(MemoryBuffer *Buffer, LLVMContext& Context,
   return M;
 }
 
+namespace {
+struct ParallelMaterializeJob {
+  const MemoryBuffer *Buffer;
+  unsigned Partition;
+  unsigned NumPartitions;
+  ParallelBitcodeCallback Callback;
+  void *Cookie;
+  bool Failed;
+  std::string ErrMsg;
+};
+}
+
+static void materializePartition(void *Arg) {
+  ParallelMaterializeJob &Job = *static_cast<ParallelMaterializeJob*>(Arg);
+  LLVMContext Context;
+  MemoryBuffer *Buffer =
+    MemoryBuffer::getMemBuffer(Job.Buffer->getBuffer(),
+                               Job.Buffer->getBufferIdentifier(), false);
+  OwningPtr<Module> M(getLazyBitcodeModule(Buffer, Context, &Job.ErrMsg));
+  if (!M) {
+    delete Buffer;
+    Job.Failed = true;
+    return;
+  }
+
+  // Every job reads the same bitcode and so computes the same split.  Cut the
+  // bodies into contiguous ranges of roughly equal size in bits.
+  std::vector<std::pair<Function*, uint64_t> > Bodies;
+  static_cast<BitcodeReader*>(M->getMaterializer())->
+    getDeferredFunctionBodies(Bodies);
+  uint64_t TotalBits = 0;
+  for (unsigned i = 0, e = Bodies.size(); i != e; ++i)
+    TotalBits += Bodies[i].second;
+
+  uint64_t Begin = TotalBits * Job.Partition / Job.NumPartitions;
+  uint64_t End = TotalBits * (Job.Partition + 1) / Job.NumPartitions;
+  uint64_t Bit = 0;
+  for (unsigned i = 0, e = Bodies.size(); i != e; ++i) {
+    // A body belongs to the partition its first bit falls in.
+    uint64_t Start = Bit;
+    Bit += Bodies[i].second;
+    if (Start < Begin || Start >= End)
+      continue;
+    if (Bodies[i].first->Materialize(&Job.ErrMsg)) {
+      Job.Failed = true;
+      return;
+    }
+  }
+
+  Job.Callback(M.get(), Job.Partition, Job.Cookie);
+}
+
+bool llvm::materializeBitcodeInParallel(const MemoryBuffer *Buffer,
+                                        unsigned NumThreads,
+                                        ParallelBitcodeCallback Callback,
+                                        void *Cookie, std::string *ErrMsg) {
+  if (NumThreads == 0)
+    NumThreads = 1;
+  std::vector<ParallelMaterializeJob> Jobs(NumThreads);
+  std::vector<void*> Args(NumThreads);
+  for (unsigned i = 0; i != NumThreads; ++i) {
+    ParallelMaterializeJob &Job = Jobs[i];
+    Job.Buffer = Buffer;
+    Job.Partition = i;
+    Job.NumPartitions = NumThreads;
+    Job.Callback = Callback;
+    Job.Cookie = Cookie;
+    Job.Failed = false;
+    Args[i] = &Job;
+  }
+
+  bool StartedMultithreaded = false;
+  if (!llvm_is_multithreaded())
+    StartedMultithreaded = llvm_start_multithreaded();
+
+  llvm_execute_on_threads(materializePartition, &Args[0], NumThreads);
+
+  if (StartedMultithreaded)
+    llvm_stop_multithreaded();
+
+  for (unsigned i = 0; i != NumThreads; ++i)
+    if (Jobs[i].Failed) {
+      if (ErrMsg)
+        *ErrMsg = Jobs[i].ErrMsg;
+      return false;
+    }
+  return true;
+}
+
 std::string llvm::getBitcodeTargetTriple(MemoryBuffer *Buffer,
                                          LLVMContext& Context,
                                          std::string *ErrMsg) {
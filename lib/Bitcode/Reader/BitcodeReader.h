@@ -172,6 +172,11 @@ class BitcodeReader : public GVMaterializer {
   // we've done this yet.
   bool SeenFirstFunctionBody;
 
+  /// SeenFunctionIndex - Set once the positions of all function bodies have
+  /// been read from a function index block.  The function blocks themselves
+  /// then need not be visited while parsing the module.
+  bool SeenFunctionIndex;
+
   /// DeferredFunctionInfo - When function bodies are initially scanned, this
   /// map contains info about where to find deferred function body in the
   /// stream.
@@ -196,13 +201,15 @@ public:
     : Context(C), TheModule(0), Buffer(buffer), BufferOwned(false),
       LazyStreamer(0), NextUnreadBit(0), SeenValueSymbolTable(false),
       ErrorString(0), ValueList(C), MDValueList(C),
-      SeenFirstFunctionBody(false), UseRelativeIDs(false) {
+      SeenFirstFunctionBody(false), SeenFunctionIndex(false),
+      UseRelativeIDs(false) {
   }
   explicit BitcodeReader(DataStreamer *streamer, LLVMContext &C)
     : Context(C), TheModule(0), Buffer(0), BufferOwned(false),
       LazyStreamer(streamer), NextUnreadBit(0), SeenValueSymbolTable(false),
       ErrorString(0), ValueList(C), MDValueList(C),
-      SeenFirstFunctionBody(false), UseRelativeIDs(false) {
+      SeenFirstFunctionBody(false), SeenFunctionIndex(false),
+      UseRelativeIDs(false) {
   }
   ~BitcodeReader() {
     FreeState();
@@ -210,6 +217,13 @@ public:
 
   void materializeForwardReferencedFunctions();
 
+  /// getDeferredFunctionBodies - Fills Bodies with the functions whose bodies
+  /// are still in the stream, in stream order, along with the approximate
+  /// size of each body in bits.  Only valid for a reader that is not
+  /// streaming.
+  void getDeferredFunctionBodies(
+                  std::vector<std::pair<Function*, uint64_t> > &Bodies) const;
+
   void FreeState();
 
   /// setBufferOwned - If this is true, the reader will destroy the MemoryBuffer
@@ -330,6 +344,7 @@ private:
   bool ParseValueSymbolTable();
   bool ParseConstants();
   bool RememberAndSkipFunctionBody();
+  bool ParseFunctionIndex(uint64_t &EndOfBodies);
   bool ParseFunctionBody(Function *F);
   bool GlobalCleanup();
   bool ResolveGlobalAndAliasInits();
@@ -38,6 +38,12 @@ EnablePreserveUseListOrdering("enable-bc-uselist-preserve",
                                        "use-list order preservation."),
                               cl::init(false), cl::Hidden);
 
+static cl::opt<bool>
+EnableFunctionIndex("enable-bc-function-index",
+                    cl::desc("Emit an index of the function bodies so that "
+                             "readers can seek directly to a body."),
+                    cl::init(false));
+
 /// These are manifest constants used by the bitcode writer. They do not need to
 /// be kept in sync with the reader, but need to be consistent within this file.
 enum {
@@ -1819,6 +1825,39 @@ static void WriteFunctionUseList(const Function *F, ValueEnumerator &VE,
   VE.purgeFunction();
 }
 
+/// WriteFunctionIndex - Emit the function index block with room for the
+/// offsets of NumBodies function bodies.  The offsets are only known once the
+/// bodies have been written, so they are filled in later by
+/// BackpatchFunctionIndex.  Returns the byte position of the offsets.
+static uint64_t WriteFunctionIndex(unsigned NumBodies,
+                                   BitstreamWriter &Stream) {
+  Stream.EnterSubblock(bitc::FUNCTION_INDEX_BLOCK_ID, 3);
+
+  BitCodeAbbrev *Abbv = new BitCodeAbbrev();
+  Abbv->Add(BitCodeAbbrevOp(bitc::FUNC_INDEX_CODE_OFFSETS));
+  Abbv->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob));
+  unsigned OffsetsAbbrev = Stream.EmitAbbrev(Abbv);
+
+  SmallVector<uint64_t, 1> Vals;
+  Vals.push_back(bitc::FUNC_INDEX_CODE_OFFSETS);
+  std::string Placeholder((NumBodies + 1) * 8, '\0');
+  Stream.EmitRecordWithBlob(OffsetsAbbrev, Vals, Placeholder);
+
+  // A blob ends on a 32-bit boundary, and its size is a multiple of four.
+  uint64_t BytePos = Stream.GetCurrentBitNo() / 8 - Placeholder.size();
+  Stream.ExitBlock();
+  return BytePos;
+}
+
+static void BackpatchFunctionIndex(uint64_t BytePos,
+                                   const std::vector<uint64_t> &Offsets,
+                                   BitstreamWriter &Stream) {
+  for (unsigned i = 0, e = Offsets.size(); i != e; ++i) {
+    Stream.BackpatchWord(BytePos + i * 8, (unsigned)Offsets[i]);
+    Stream.BackpatchWord(BytePos + i * 8 + 4, (unsigned)(Offsets[i] >> 32));
+  }
+}
+
 // Emit use-lists.
 static void WriteModuleUseLists(const Module *M, ValueEnumerator &VE,
                                 BitstreamWriter &Stream) {
@@ -1859,8 +1898,10 @@ static void WriteModuleUseLists(const Module *M, ValueEnumerator &VE,
   Stream.ExitBlock();
 }
 
-/// WriteModule - Emit the specified module to the bitstream.
-static void WriteModule(const Module *M, BitstreamWriter &Stream) {
+/// WriteModule - Emit the module block.  StartBit is the position of the
+/// bitcode magic number in the stream, which offsets are relative to.
+static void WriteModule(const Module *M, BitstreamWriter &Stream,
+                        uint64_t StartBit) {
   Stream.EnterSubblock(bitc::MODULE_BLOCK_ID, 3);
 
   SmallVector<unsigned, 1> Vals;
@@ -1903,10 +1944,35 @@ static void WriteModule(const Module *M, BitstreamWriter &Stream) {
   if (EnablePreserveUseListOrdering)
     WriteModuleUseLists(M, VE, Stream);
 
-  // Emit function bodies.
+  // Emit function bodies, preceded by their index if requested.
+  unsigned NumBodies = 0;
   for (Module::const_iterator F = M->begin(), E = M->end(); F != E; ++F)
     if (!F->isDeclaration())
-      WriteFunction(*F, VE, Stream);
+      ++NumBodies;
+  bool EmitIndex = EnableFunctionIndex && NumBodies != 0;
+  uint64_t IndexPos = 0;
+  std::vector<uint64_t> BodyOffsets;
+  if (EmitIndex) {
+    IndexPos = WriteFunctionIndex(NumBodies, Stream);
+    BodyOffsets.reserve(NumBodies + 1);
+  }
+
+  for (Module::const_iterator F = M->begin(), E = M->end(); F != E; ++F) {
+    if (F->isDeclaration())
+      continue;
+    // The reader remembers a body by the position after the block ID of
+    // the ENTER_SUBBLOCK, which is a single VBR chunk.
+    assert(bitc::FUNCTION_BLOCK_ID < (1U << (bitc::BlockIDWidth - 1)));
+    if (EmitIndex)
+      BodyOffsets.push_back(Stream.GetCurrentBitNo() - StartBit +
+                            Stream.GetAbbrevIDWidth() + bitc::BlockIDWidth);
+    WriteFunction(*F, VE, Stream);
+  }
+
+  if (EmitIndex) {
+    BodyOffsets.push_back(Stream.GetCurrentBitNo() - StartBit);
+    BackpatchFunctionIndex(IndexPos, BodyOffsets, Stream);
+  }
 
   Stream.ExitBlock();
 }
@@ -1999,6 +2065,7 @@ void llvm::WriteBitcodeToFile(const Module *M, raw_ostream &Out) {
   // Emit the module into the buffer.
   {
     BitstreamWriter Stream(Buffer);
+    uint64_t StartBit = Stream.GetCurrentBitNo();
 
     // Emit the file header.
     Stream.Emit((unsigned)'B', 8);
@@ -2009,7 +2076,7 @@ void llvm::WriteBitcodeToFile(const Module *M, raw_ostream &Out) {
     Stream.Emit(0xD, 4);
 
     // Emit the module.
-    WriteModule(M, Stream);
+    WriteModule(M, Stream, StartBit);
   }
 
   if (TT.isOSDarwin())
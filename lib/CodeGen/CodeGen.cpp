@@ -71,6 +71,7 @@ void llvm::initializeCodeGen(PassRegistry &Registry) {
   initializeVirtRegRewriterPass(Registry);
   initializeLowerIntrinsicsPass(Registry);
   initializeMachineFunctionPrinterPassPass(Registry);
+  initializeMachineMemoryReportPass(Registry);
 }
 
 void LLVMInitializeCodeGen(LLVMPassRegistryRef R) {
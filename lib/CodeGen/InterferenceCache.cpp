@@ -13,12 +13,24 @@
 
 #define DEBUG_TYPE "regalloc"
 #include "InterferenceCache.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/CodeGen/LiveIntervalAnalysis.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Target/TargetRegisterInfo.h"
 
 using namespace llvm;
 
+STATISTIC(NumEntryHits,    "Number of interference cache entry hits");
+STATISTIC(NumEntryRevalid, "Number of interference cache entries revalidated");
+STATISTIC(NumEntryMisses,  "Number of interference cache entry misses");
+STATISTIC(NumBlockUpdates, "Number of block interferences recomputed");
+
+static cl::opt<unsigned>
+CacheBudget("interference-cache-budget", cl::Hidden, cl::init(4 << 20),
+            cl::desc("Bytes of block interference the cache may use before "
+                     "it stops growing past the minimum size"));
+
 // Static member used for null interference cursors.
 InterferenceCache::BlockInterference InterferenceCache::Cursor::NoInterference;
 
@@ -31,25 +43,48 @@ void InterferenceCache::init(MachineFunction *mf,
   LIUArray = liuarray;
   TRI = tri;
   PhysRegEntries.assign(TRI->getNumRegs(), 0);
-  for (unsigned i = 0; i != CacheEntries; ++i)
+
+  // Allocation tries the registers of one class in turn, so ideally a whole
+  // class fits in the cache. Each entry keeps interference for every block,
+  // so large functions stay at the minimum size.
+  unsigned NumEntries = MaxCursors;
+  for (TargetRegisterInfo::regclass_iterator I = TRI->regclass_begin(),
+       E = TRI->regclass_end(); I != E; ++I)
+    if ((*I)->isAllocatable())
+      NumEntries = std::max(NumEntries, (*I)->getNumRegs());
+  NumEntries = std::min<unsigned>(NumEntries, MaxCacheEntries);
+  uint64_t EntrySize = uint64_t(mf->getNumBlockIDs() + 1) *
+                       sizeof(BlockInterference);
+  NumEntries = std::min<uint64_t>(NumEntries, CacheBudget / EntrySize);
+  NumEntries = std::max<unsigned>(NumEntries, MaxCursors);
+
+  Entries.resize(NumEntries);
+  for (unsigned i = 0; i != NumEntries; ++i)
     Entries[i].clear(mf, indexes, lis);
+  if (RoundRobin >= NumEntries)
+    RoundRobin = 0;
 }
 
 InterferenceCache::Entry *InterferenceCache::get(unsigned PhysReg) {
+  unsigned NumEntries = Entries.size();
   unsigned E = PhysRegEntries[PhysReg];
-  if (E < CacheEntries && Entries[E].getPhysReg() == PhysReg) {
-    if (!Entries[E].valid(LIUArray, TRI))
+  if (E < NumEntries && Entries[E].getPhysReg() == PhysReg) {
+    if (!Entries[E].valid(LIUArray, TRI)) {
+      ++NumEntryRevalid;
       Entries[E].revalidate(LIUArray, TRI);
+    } else
+      ++NumEntryHits;
     return &Entries[E];
   }
   // No valid entry exists, pick the next round-robin entry.
+  ++NumEntryMisses;
   E = RoundRobin;
-  if (++RoundRobin == CacheEntries)
+  if (++RoundRobin == NumEntries)
     RoundRobin = 0;
-  for (unsigned i = 0; i != CacheEntries; ++i) {
+  for (unsigned i = 0; i != NumEntries; ++i) {
     // Skip entries that are in use.
     if (Entries[E].hasRefs()) {
-      if (++E == CacheEntries)
+      if (++E == NumEntries)
         E = 0;
       continue;
     }
@@ -104,6 +139,7 @@ bool InterferenceCache::Entry::valid(LiveIntervalUnion *LIUArray,
 }
 
 void InterferenceCache::Entry::update(unsigned MBBNum) {
+  ++NumBlockUpdates;
   SlotIndex Start, Stop;
   tie(Start, Stop) = Indexes->getMBBRange(MBBNum);
 
@@ -129,9 +129,11 @@ class InterferenceCache {
   };
 
   // We don't keep a cache entry for every physical register, that would use too
-  // much memory. Instead, a fixed number of cache entries are used in a round-
-  // robin manner.
-  enum { CacheEntries = 32 };
+  // much memory. Instead, a limited number of cache entries are used in a
+  // round-robin manner. There are always enough entries for MaxCursors live
+  // cursors; init() adds more when the register classes are large and the
+  // function is small enough that the extra Blocks arrays are cheap.
+  enum { MaxCursors = 32, MaxCacheEntries = 128 };
 
   // Point to an entry for each physreg. The entry pointed to may not be up to
   // date, and it may have been reused for a different physreg.
@@ -141,7 +143,7 @@ class InterferenceCache {
   unsigned RoundRobin;
 
   // The actual cache entries.
-  Entry Entries[CacheEntries];
+  std::vector<Entry> Entries;
 
   // get - Get a valid entry for PhysReg.
   Entry *get(unsigned PhysReg);
@@ -155,7 +157,11 @@ public:
 
   /// getMaxCursors - Return the maximum number of concurrent cursors that can
   /// be supported.
-  unsigned getMaxCursors() const { return CacheEntries; }
+  unsigned getMaxCursors() const { return MaxCursors; }
+
+  /// getNumEntries - Return the number of cache entries used for the current
+  /// function.
+  unsigned getNumEntries() const { return Entries.size(); }
 
   /// Cursor - The primary query interface for the block interference cache.
   class Cursor {
@@ -191,7 +197,7 @@ public:
     /// setPhysReg - Point this cursor to PhysReg's interference.
     void setPhysReg(InterferenceCache &Cache, unsigned PhysReg) {
       // Release reference before getting a new one. That guarantees we can
-      // actually have CacheEntries live cursors.
+      // actually have MaxCursors live cursors.
       setEntry(0);
       if (PhysReg)
         setEntry(Cache.get(PhysReg));
@@ -76,6 +76,7 @@ raw_ostream &llvm::operator<<(raw_ostream &OS, const MachineBasicBlock &MBB) {
 void ilist_traits<MachineBasicBlock>::addNodeToList(MachineBasicBlock *N) {
   MachineFunction &MF = *N->getParent();
   N->Number = MF.addToMBBNumbering(N);
+  MF.invalidateCFG();
 
   // Make sure the instructions have their operands in the reginfo lists.
   MachineRegisterInfo &RegInfo = MF.getRegInfo();
@@ -88,6 +89,7 @@ void ilist_traits<MachineBasicBlock>::addNodeToList(MachineBasicBlock *N) {
 
 void ilist_traits<MachineBasicBlock>::removeNodeFromList(MachineBasicBlock *N) {
   N->getParent()->removeFromMBBNumbering(N->Number);
+  N->getParent()->invalidateCFG();
   N->Number = -1;
   LeakDetector::addGarbageObject(N);
 }
@@ -530,12 +532,15 @@ void MachineBasicBlock::replaceSuccessor(MachineBasicBlock *Old,
 
 void MachineBasicBlock::addPredecessor(MachineBasicBlock *pred) {
   Predecessors.push_back(pred);
+  // Every edge update goes through here or removePredecessor.
+  getParent()->invalidateCFG();
 }
 
 void MachineBasicBlock::removePredecessor(MachineBasicBlock *pred) {
   pred_iterator I = std::find(Predecessors.begin(), Predecessors.end(), pred);
   assert(I != Predecessors.end() && "Pred is not a predecessor of this block!");
   Predecessors.erase(I);
+  getParent()->invalidateCFG();
 }
 
 void MachineBasicBlock::transferSuccessors(MachineBasicBlock *fromMBB) {
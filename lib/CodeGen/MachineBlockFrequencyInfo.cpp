@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
+#include "llvm/ADT/OwningPtr.h"
 #include "llvm/Analysis/BlockFrequencyImpl.h"
 #include "llvm/CodeGen/MachineBranchProbabilityInfo.h"
 #include "llvm/CodeGen/Passes.h"
@@ -28,15 +29,12 @@ INITIALIZE_PASS_END(MachineBlockFrequencyInfo, "machine-block-freq",
 char MachineBlockFrequencyInfo::ID = 0;
 
 
-MachineBlockFrequencyInfo::MachineBlockFrequencyInfo() : MachineFunctionPass(ID) {
+MachineBlockFrequencyInfo::MachineBlockFrequencyInfo()
+  : MachineFunctionPass(ID), MBFI(0) {
   initializeMachineBlockFrequencyInfoPass(*PassRegistry::getPassRegistry());
-  MBFI = new BlockFrequencyImpl<MachineBasicBlock, MachineFunction,
-                                MachineBranchProbabilityInfo>();
 }
 
-MachineBlockFrequencyInfo::~MachineBlockFrequencyInfo() {
-  delete MBFI;
-}
+MachineBlockFrequencyInfo::~MachineBlockFrequencyInfo() {}
 
 void MachineBlockFrequencyInfo::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequired<MachineBranchProbabilityInfo>();
@@ -44,9 +42,26 @@ void MachineBlockFrequencyInfo::getAnalysisUsage(AnalysisUsage &AU) const {
   MachineFunctionPass::getAnalysisUsage(AU);
 }
 
+namespace {
+struct BlockFrequencyResult : public MachineCFGAnalysisResult {
+  OwningPtr<BlockFrequencyImpl<MachineBasicBlock, MachineFunction,
+                               MachineBranchProbabilityInfo> > MBFI;
+};
+}
+
 bool MachineBlockFrequencyInfo::runOnMachineFunction(MachineFunction &F) {
+  BlockFrequencyResult &Result =
+    F.getCFGAnalysisResult<BlockFrequencyResult>(&ID);
+  if (!Result.MBFI)
+    Result.MBFI.reset(new BlockFrequencyImpl<MachineBasicBlock, MachineFunction,
+                                             MachineBranchProbabilityInfo>());
+  MBFI = Result.MBFI.get();
+  if (isCFGUnchanged(F, Result.CFGVersion))
+    return false;
+
   MachineBranchProbabilityInfo &MBPI = getAnalysis<MachineBranchProbabilityInfo>();
   MBFI->doFunction(&F, &MBPI);
+  Result.CFGVersion = F.getCFGVersion();
   return false;
 }
 
@@ -34,26 +34,33 @@ void MachineDominatorTree::getAnalysisUsage(AnalysisUsage &AU) const {
   MachineFunctionPass::getAnalysisUsage(AU);
 }
 
+namespace {
+struct DomTreeResult : public MachineCFGAnalysisResult {
+  DominatorTreeBase<MachineBasicBlock> DT;
+  DomTreeResult() : DT(false) {}
+};
+}
+
 bool MachineDominatorTree::runOnMachineFunction(MachineFunction &F) {
+  DomTreeResult &Result = F.getCFGAnalysisResult<DomTreeResult>(&ID);
+  DT = &Result.DT;
+  if (isCFGUnchanged(F, Result.CFGVersion))
+    return false;
+
   DT->recalculate(F);
+  Result.CFGVersion = F.getCFGVersion();
 
   return false;
 }
 
 MachineDominatorTree::MachineDominatorTree()
-    : MachineFunctionPass(ID) {
+    : MachineFunctionPass(ID), DT(0) {
   initializeMachineDominatorTreePass(*PassRegistry::getPassRegistry());
-  DT = new DominatorTreeBase<MachineBasicBlock>(false);
 }
 
-MachineDominatorTree::~MachineDominatorTree() {
-  delete DT;
-}
-
-void MachineDominatorTree::releaseMemory() {
-  DT->releaseMemory();
-}
+MachineDominatorTree::~MachineDominatorTree() {}
 
 void MachineDominatorTree::print(raw_ostream &OS, const Module*) const {
-  DT->print(OS);
+  if (DT)
+    DT->print(OS);
 }
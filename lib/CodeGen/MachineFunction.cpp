@@ -30,7 +30,9 @@
 #include "llvm/IR/Function.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/MC/MCContext.h"
+#include "llvm/Support/Atomic.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/GraphWriter.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetFrameLowering.h"
@@ -45,6 +47,8 @@ using namespace llvm;
 // Out of line virtual method.
 MachineFunctionInfo::~MachineFunctionInfo() {}
 
+MachineCFGAnalysisResult::~MachineCFGAnalysisResult() {}
+
 void ilist_traits<MachineBasicBlock>::deleteNode(MachineBasicBlock *MBB) {
   MBB->getParent()->DeleteMachineBasicBlock(MBB);
 }
@@ -73,9 +77,22 @@ MachineFunction::MachineFunction(const Function *F, const TargetMachine &TM,
                          TM.getTargetLowering()->getPrefFunctionAlignment());
   FunctionNumber = FunctionNum;
   JumpTableInfo = 0;
+  invalidateCFG();
+}
+
+// The last CFG version handed out. Version 0 is never assigned, so analyses
+// can use it to mean that they have no result.
+static volatile sys::cas_flag LastCFGVersion = 0;
+
+void MachineFunction::invalidateCFG() {
+  CFGVersion = sys::AtomicIncrement(&LastCFGVersion);
 }
 
 MachineFunction::~MachineFunction() {
+  for (DenseMap<const void*, MachineCFGAnalysisResult*>::iterator
+       I = CFGAnalyses.begin(), E = CFGAnalyses.end(); I != E; ++I)
+    delete I->second;
+
   // Don't call destructors on MachineInstr and MachineOperand. All of their
   // memory comes from the BumpPtrAllocator which is about to be purged.
   //
@@ -313,6 +330,37 @@ StringRef MachineFunction::getName() const {
   return getFunction()->getName();
 }
 
+void MachineFunction::printMemoryUsage(raw_ostream &OS) const {
+  unsigned NumBlocks = 0, NumInstrs = 0, NumOperands = 0, OperandSlots = 0;
+  unsigned NumMemRefs = 0;
+  for (const_iterator BB = begin(), BE = end(); BB != BE; ++BB) {
+    ++NumBlocks;
+    for (MachineBasicBlock::const_instr_iterator I = BB->instr_begin(),
+         E = BB->instr_end(); I != E; ++I) {
+      ++NumInstrs;
+      NumOperands += I->getNumOperands();
+      OperandSlots += I->getOperandCapacity();
+      NumMemRefs += I->memoperands_end() - I->memoperands_begin();
+    }
+  }
+
+  uint64_t BlockBytes = uint64_t(NumBlocks) * sizeof(MachineBasicBlock);
+  uint64_t InstrBytes = uint64_t(NumInstrs) * sizeof(MachineInstr);
+  uint64_t OperandBytes = uint64_t(OperandSlots) * sizeof(MachineOperand);
+
+  OS << "# Memory usage of machine function " << getName() << ":\n";
+  OS << format("  %8u blocks       %10llu bytes\n", NumBlocks,
+               (unsigned long long)BlockBytes);
+  OS << format("  %8u instructions %10llu bytes\n", NumInstrs,
+               (unsigned long long)InstrBytes);
+  OS << format("  %8u operands     %10llu bytes (%u slots allocated)\n",
+               NumOperands, (unsigned long long)OperandBytes, OperandSlots);
+  OS << format("  %8u memoperands\n", NumMemRefs);
+  OS << format("  %8u virtual registers\n", RegInfo->getNumVirtRegs());
+  OS << format("  allocator total    %10llu bytes\n",
+               (unsigned long long)Allocator.getTotalMemory());
+}
+
 void MachineFunction::print(raw_ostream &OS, SlotIndexes *Indexes) const {
   OS << "# Machine code for function " << getName() << ": ";
   if (RegInfo) {
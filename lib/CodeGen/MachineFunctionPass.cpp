@@ -11,13 +11,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#define DEBUG_TYPE "codegen"
 #include "llvm/IR/Function.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineFunctionAnalysis.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/Passes.h"
+#include "llvm/PassManagers.h"
 using namespace llvm;
 
+STATISTIC(NumCFGAnalysesReused,
+          "Number of CFG analysis runs avoided because the CFG was unchanged");
+
 Pass *MachineFunctionPass::createPrinterPass(raw_ostream &O,
                                              const std::string &Banner) const {
   return createMachineFunctionPrinterPass(O, Banner);
@@ -54,3 +61,14 @@ void MachineFunctionPass::getAnalysisUsage(AnalysisUsage &AU) const {
 
   FunctionPass::getAnalysisUsage(AU);
 }
+
+bool MachineFunctionPass::isCFGUnchanged(const MachineFunction &MF,
+                                         unsigned CFGVersion) {
+  if (CFGVersion != MF.getCFGVersion())
+    return false;
+  ++NumCFGAnalysesReused;
+  getResolver()->getPMDataManager().dumpPassInfo(this, REUSING_MSG,
+                                                 ON_FUNCTION_MSG,
+                                                 MF.getName());
+  return true;
+}
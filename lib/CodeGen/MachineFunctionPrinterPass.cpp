@@ -55,6 +55,38 @@ char &llvm::MachineFunctionPrinterPassID = MachineFunctionPrinterPass::ID;
 INITIALIZE_PASS(MachineFunctionPrinterPass, "print-machineinstrs",
                 "Machine Function Printer", false, false)
 
+namespace {
+/// MachineMemoryReport - This is a pass to print how much memory the blocks,
+/// instructions and operands of a MachineFunction use.
+///
+struct MachineMemoryReport : public MachineFunctionPass {
+  static char ID;
+
+  raw_ostream &OS;
+
+  MachineMemoryReport() : MachineFunctionPass(ID), OS(dbgs()) {}
+  explicit MachineMemoryReport(raw_ostream &os)
+      : MachineFunctionPass(ID), OS(os) {}
+
+  const char *getPassName() const { return "MachineFunction Memory Report"; }
+
+  virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+    AU.setPreservesAll();
+    MachineFunctionPass::getAnalysisUsage(AU);
+  }
+
+  bool runOnMachineFunction(MachineFunction &MF) {
+    MF.printMemoryUsage(OS);
+    return false;
+  }
+};
+
+char MachineMemoryReport::ID = 0;
+}
+
+INITIALIZE_PASS(MachineMemoryReport, "machine-memory-report",
+                "Machine Function Memory Report", false, false)
+
 namespace llvm {
 /// Returns a newly-created MachineFunction Printer pass. The
 /// default banner is empty.
@@ -64,4 +96,8 @@ MachineFunctionPass *createMachineFunctionPrinterPass(raw_ostream &OS,
   return new MachineFunctionPrinterPass(OS, Banner);
 }
 
+MachineFunctionPass *createMachineMemoryReportPass(raw_ostream &OS) {
+  return new MachineMemoryReport(OS);
+}
+
 }
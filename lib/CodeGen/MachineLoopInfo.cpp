@@ -34,9 +34,21 @@ INITIALIZE_PASS_END(MachineLoopInfo, "machine-loops",
 
 char &llvm::MachineLoopInfoID = MachineLoopInfo::ID;
 
-bool MachineLoopInfo::runOnMachineFunction(MachineFunction &) {
-  releaseMemory();
-  LI.Analyze(getAnalysis<MachineDominatorTree>().getBase());
+namespace {
+struct LoopInfoResult : public MachineCFGAnalysisResult {
+  LoopInfoBase<MachineBasicBlock, MachineLoop> LI;
+};
+}
+
+bool MachineLoopInfo::runOnMachineFunction(MachineFunction &MF) {
+  LoopInfoResult &Result = MF.getCFGAnalysisResult<LoopInfoResult>(&ID);
+  LI = &Result.LI;
+  if (isCFGUnchanged(MF, Result.CFGVersion))
+    return false;
+
+  LI->releaseMemory();
+  LI->Analyze(getAnalysis<MachineDominatorTree>().getBase());
+  Result.CFGVersion = MF.getCFGVersion();
   return false;
 }
 
@@ -29,6 +29,7 @@
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/GraphWriter.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <queue>
 
@@ -66,9 +67,17 @@ static cl::opt<bool> EnableMacroFusion("misched-fusion", cl::Hidden,
 static cl::opt<bool> VerifyScheduling("verify-misched", cl::Hidden,
   cl::desc("Verify machine instrs before and after machine scheduling"));
 
+static cl::opt<unsigned> HugeRegionCandidates("misched-huge-region-cands",
+  cl::Hidden, cl::init(16),
+  cl::desc("Number of ready nodes compared per pick in huge regions "
+           "(0 = all)"));
+
 // DAG subtrees must have at least this many nodes.
 static const unsigned MinSubtreeSize = 8;
 
+// Timers for the phases of each region, reported under -time-passes.
+static const char *const TimerGroupName = "Machine Scheduler Regions";
+
 //===----------------------------------------------------------------------===//
 // Machine Instruction Scheduling Pass and Registry
 //===----------------------------------------------------------------------===//
@@ -538,6 +547,8 @@ updateScheduledPressure(const std::vector<unsigned> &NewMaxPressure) {
 void ScheduleDAGMI::schedule() {
   buildDAGWithRegPressure();
 
+  NamedRegionTimer T("List Scheduling", TimerGroupName, TimePassesIsEnabled);
+
   Topo.InitDAGTopologicalSorting();
 
   postprocessDAG();
@@ -580,6 +591,9 @@ void ScheduleDAGMI::schedule() {
 
 /// Build the DAG and setup three register pressure trackers.
 void ScheduleDAGMI::buildDAGWithRegPressure() {
+  NamedRegionTimer T("Build Scheduling DAG", TimerGroupName,
+                     TimePassesIsEnabled);
+
   // Initialize the register pressure tracker used by buildSchedGraph.
   RPTracker.init(&MF, RegClassInfo, LIS, BB, LiveRegionEnd);
 
@@ -2181,7 +2195,15 @@ void ConvergingScheduler::pickNodeFromQueue(SchedBoundary &Zone,
   // getMaxPressureDelta temporarily modifies the tracker.
   RegPressureTracker &TempTracker = const_cast<RegPressureTracker&>(RPTracker);
 
-  for (ReadyQueue::iterator I = Q.begin(), E = Q.end(); I != E; ++I) {
+  // Comparing every ready node is quadratic in a huge region, where thousands
+  // of nodes may be ready at once. Fall back to a plain list scheduler that
+  // only considers the first few.
+  ReadyQueue::iterator E = Q.end();
+  if (DAG->isHugeRegion() && HugeRegionCandidates &&
+      Q.size() > HugeRegionCandidates)
+    E = Q.begin() + HugeRegionCandidates;
+
+  for (ReadyQueue::iterator I = Q.begin(); I != E; ++I) {
 
     SchedCandidate TryCand(Cand.Policy);
     TryCand.SU = *I;
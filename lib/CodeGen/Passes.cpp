@@ -24,6 +24,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLowering.h"
 #include "llvm/Target/TargetSubtargetInfo.h"
 #include "llvm/Transforms/Scalar.h"
@@ -52,6 +53,9 @@ static cl::opt<bool> DisableMachineLICM("disable-machine-licm", cl::Hidden,
     cl::desc("Disable Machine LICM"));
 static cl::opt<bool> DisableMachineCSE("disable-machine-cse", cl::Hidden,
     cl::desc("Disable Machine Common Subexpression Elimination"));
+static cl::opt<bool> ReportMachineMemory("report-machine-memory", cl::Hidden,
+    cl::desc("Print the memory used by each machine function before "
+             "register allocation and before emission"));
 static cl::opt<cl::boolOrDefault>
 OptimizeRegAlloc("optimize-regalloc", cl::Hidden,
     cl::desc("Enable optimized register allocation compilation path."));
@@ -491,6 +495,9 @@ void TargetPassConfig::addMachinePasses() {
   if (addPreRegAlloc())
     printAndVerify("After PreRegAlloc passes");
 
+  if (ReportMachineMemory)
+    addPass(createMachineMemoryReportPass(errs()));
+
   // Run register allocation and passes that are tightly coupled with it,
   // including phi elimination and scheduling.
   if (getOptimizeRegAlloc())
@@ -536,6 +543,9 @@ void TargetPassConfig::addMachinePasses() {
 
   if (addPreEmitPass())
     printAndVerify("After PreEmit passes");
+
+  if (ReportMachineMemory)
+    addPass(createMachineMemoryReportPass(errs()));
 }
 
 /// Add passes that optimize machine instructions in SSA form.
@@ -618,11 +628,16 @@ RegAlloc("regalloc",
 /// A target that uses the standard regalloc pass order for fast or optimized
 /// allocation may still override this for per-target regalloc
 /// selection. But -regalloc=... always takes precedence.
+///
+/// With TargetOptions::UseLinearScanRegAlloc, CodeGenOpt::Less uses the linear
+/// scan allocator, which avoids the cost of live range splitting but still
+/// allocates across blocks.
 FunctionPass *TargetPassConfig::createTargetRegisterAllocator(bool Optimized) {
-  if (Optimized)
-    return createGreedyRegisterAllocator();
-  else
+  if (!Optimized)
     return createFastRegisterAllocator();
+  if (getOptLevel() == CodeGenOpt::Less && TM->Options.UseLinearScanRegAlloc)
+    return createLinearScanRegisterAllocator();
+  return createGreedyRegisterAllocator();
 }
 
 /// Find and instantiate the register allocation pass requested by this target
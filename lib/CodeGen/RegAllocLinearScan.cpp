@@ -0,0 +1,294 @@
+//===-- RegAllocLinearScan.cpp - Linear Scan Register Allocator -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the RALinearScan function pass, a register allocator that
+// sits between the fast and greedy allocators in both compile time and code
+// quality.  It visits live virtual registers in order of their start index and
+// never splits them.  When no register is free it evicts cheaper interfering
+// live ranges or spills the current one.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "regalloc"
+#include "llvm/CodeGen/Passes.h"
+#include "AllocationOrder.h"
+#include "LiveDebugVariables.h"
+#include "RegAllocBase.h"
+#include "Spiller.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/CalcSpillWeights.h"
+#include "llvm/CodeGen/LiveIntervalAnalysis.h"
+#include "llvm/CodeGen/LiveRangeEdit.h"
+#include "llvm/CodeGen/LiveRegMatrix.h"
+#include "llvm/CodeGen/LiveStackAnalysis.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineLoopInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+#include "llvm/CodeGen/VirtRegMap.h"
+#include "llvm/PassAnalysisSupport.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+#include <queue>
+
+using namespace llvm;
+
+STATISTIC(NumLSEvicted, "Number of live ranges evicted by linear scan");
+STATISTIC(NumLSSpilled, "Number of live ranges spilled by linear scan");
+
+static RegisterRegAlloc linearScanRegAlloc("linearscan",
+                                           "linear scan register allocator",
+                                           createLinearScanRegisterAllocator);
+
+namespace {
+  /// The queue holds (start, reg) pairs.  The start index is recorded when the
+  /// live range is queued, since the spiller may shrink it while it waits.
+  typedef std::pair<SlotIndex, unsigned> QueueEntry;
+
+  /// CompStartIndex - Order the queue so that the live range starting first
+  /// is allocated first.  Ties are broken by register number so the order
+  /// does not depend on pointer values.
+  struct CompStartIndex {
+    bool operator()(const QueueEntry &A, const QueueEntry &B) const {
+      if (A.first != B.first)
+        return B.first < A.first;
+      return A.second > B.second;
+    }
+  };
+}
+
+namespace {
+/// RALinearScan allocates live virtual registers in the order they start, as a
+/// classic linear scan allocator would.  It uses the same LiveIntervals and
+/// LiveRegMatrix infrastructure as the greedy allocator, but performs no live
+/// range splitting and only a single eviction search per live range, so its
+/// cost is close to linear in the number of live ranges.
+class RALinearScan : public MachineFunctionPass, public RegAllocBase
+{
+  // context
+  MachineFunction *MF;
+
+  // state
+  OwningPtr<Spiller> SpillerInstance;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      CompStartIndex> Queue;
+
+public:
+  RALinearScan();
+
+  /// Return the pass name.
+  virtual const char* getPassName() const {
+    return "Linear Scan Register Allocator";
+  }
+
+  /// RALinearScan analysis usage.
+  virtual void getAnalysisUsage(AnalysisUsage &AU) const;
+
+  virtual void releaseMemory();
+
+  virtual Spiller &spiller() { return *SpillerInstance; }
+
+  virtual void enqueue(LiveInterval *LI) {
+    SlotIndex Start = LI->empty() ? LIS->getSlotIndexes()->getZeroIndex()
+                                  : LI->beginIndex();
+    Queue.push(std::make_pair(Start, LI->reg));
+  }
+
+  virtual LiveInterval *dequeue() {
+    if (Queue.empty())
+      return 0;
+    LiveInterval *LI = &LIS->getInterval(Queue.top().second);
+    Queue.pop();
+    return LI;
+  }
+
+  virtual unsigned selectOrSplit(LiveInterval &VirtReg,
+                                 SmallVectorImpl<LiveInterval*> &SplitVRegs);
+
+  /// Perform register allocation.
+  virtual bool runOnMachineFunction(MachineFunction &mf);
+
+  static char ID;
+
+private:
+  bool getEvictionCost(LiveInterval &VirtReg, unsigned PhysReg, float &Cost);
+  void evictInterferences(LiveInterval &VirtReg, unsigned PhysReg,
+                          SmallVectorImpl<LiveInterval*> &SplitVRegs);
+};
+
+char RALinearScan::ID = 0;
+
+} // end anonymous namespace
+
+RALinearScan::RALinearScan(): MachineFunctionPass(ID) {
+  initializeLiveDebugVariablesPass(*PassRegistry::getPassRegistry());
+  initializeLiveIntervalsPass(*PassRegistry::getPassRegistry());
+  initializeSlotIndexesPass(*PassRegistry::getPassRegistry());
+  initializeRegisterCoalescerPass(*PassRegistry::getPassRegistry());
+  initializeMachineSchedulerPass(*PassRegistry::getPassRegistry());
+  initializeCalculateSpillWeightsPass(*PassRegistry::getPassRegistry());
+  initializeLiveStacksPass(*PassRegistry::getPassRegistry());
+  initializeMachineDominatorTreePass(*PassRegistry::getPassRegistry());
+  initializeMachineLoopInfoPass(*PassRegistry::getPassRegistry());
+  initializeVirtRegMapPass(*PassRegistry::getPassRegistry());
+  initializeLiveRegMatrixPass(*PassRegistry::getPassRegistry());
+}
+
+void RALinearScan::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesCFG();
+  AU.addRequired<AliasAnalysis>();
+  AU.addPreserved<AliasAnalysis>();
+  AU.addRequired<LiveIntervals>();
+  AU.addPreserved<LiveIntervals>();
+  AU.addPreserved<SlotIndexes>();
+  AU.addRequired<LiveDebugVariables>();
+  AU.addPreserved<LiveDebugVariables>();
+  AU.addRequired<CalculateSpillWeights>();
+  AU.addRequired<LiveStacks>();
+  AU.addPreserved<LiveStacks>();
+  AU.addRequiredID(MachineDominatorsID);
+  AU.addPreservedID(MachineDominatorsID);
+  AU.addRequired<MachineLoopInfo>();
+  AU.addPreserved<MachineLoopInfo>();
+  AU.addRequired<VirtRegMap>();
+  AU.addPreserved<VirtRegMap>();
+  AU.addRequired<LiveRegMatrix>();
+  AU.addPreserved<LiveRegMatrix>();
+  MachineFunctionPass::getAnalysisUsage(AU);
+}
+
+void RALinearScan::releaseMemory() {
+  SpillerInstance.reset(0);
+}
+
+/// getEvictionCost - Return false if the live ranges assigned to PhysReg that
+/// interfere with VirtReg cannot be evicted.  Otherwise set Cost to the largest
+/// spill weight among them.
+bool RALinearScan::getEvictionCost(LiveInterval &VirtReg, unsigned PhysReg,
+                                   float &Cost) {
+  Cost = 0;
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units) {
+    LiveIntervalUnion::Query &Q = Matrix->query(VirtReg, *Units);
+    Q.collectInterferingVRegs();
+    if (Q.seenUnspillableVReg())
+      return false;
+    for (unsigned i = Q.interferingVRegs().size(); i; --i) {
+      LiveInterval *Intf = Q.interferingVRegs()[i - 1];
+      if (!Intf->isSpillable() || Intf->weight >= VirtReg.weight)
+        return false;
+      Cost = std::max(Cost, Intf->weight);
+    }
+  }
+  return true;
+}
+
+/// evictInterferences - Unassign and spill every live range assigned to
+/// PhysReg that interferes with VirtReg.  The new live ranges created by the
+/// spiller are appended to SplitVRegs.
+void RALinearScan::evictInterferences(LiveInterval &VirtReg, unsigned PhysReg,
+                                    SmallVectorImpl<LiveInterval*> &SplitVRegs) {
+  // Collect the interferences before mutating the unions.
+  SmallVector<LiveInterval*, 8> Intfs;
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units) {
+    LiveIntervalUnion::Query &Q = Matrix->query(VirtReg, *Units);
+    Q.collectInterferingVRegs();
+    ArrayRef<LiveInterval*> IVR = Q.interferingVRegs();
+    Intfs.append(IVR.begin(), IVR.end());
+  }
+
+  for (unsigned i = 0, e = Intfs.size(); i != e; ++i) {
+    LiveInterval &Intf = *Intfs[i];
+    // Skip duplicates.
+    if (!VRM->hasPhys(Intf.reg))
+      continue;
+    DEBUG(dbgs() << "evicting " << Intf << " from " << PrintReg(PhysReg, TRI)
+                 << '\n');
+    ++NumLSEvicted;
+    Matrix->unassign(Intf);
+    LiveRangeEdit LRE(&Intf, SplitVRegs, *MF, *LIS, VRM);
+    spiller().spill(LRE);
+  }
+}
+
+// Each live range gets one pass over its allocation order.  A free register is
+// taken immediately; otherwise the register whose interferences are cheapest
+// to evict is chosen, provided they are all cheaper than VirtReg.  If there is
+// no such register, VirtReg itself is spilled.
+unsigned RALinearScan::selectOrSplit(LiveInterval &VirtReg,
+                                     SmallVectorImpl<LiveInterval*> &SplitVRegs) {
+  unsigned BestPhys = 0;
+  float BestCost = 0;
+
+  AllocationOrder Order(VirtReg.reg, *VRM, RegClassInfo);
+  while (unsigned PhysReg = Order.next()) {
+    switch (Matrix->checkInterference(VirtReg, PhysReg)) {
+    case LiveRegMatrix::IK_Free:
+      return PhysReg;
+
+    case LiveRegMatrix::IK_VirtReg: {
+      float Cost;
+      if (getEvictionCost(VirtReg, PhysReg, Cost) &&
+          (!BestPhys || Cost < BestCost)) {
+        BestPhys = PhysReg;
+        BestCost = Cost;
+      }
+      continue;
+    }
+
+    default:
+      // RegMask or RegUnit interference.
+      continue;
+    }
+  }
+
+  if (BestPhys) {
+    evictInterferences(VirtReg, BestPhys, SplitVRegs);
+    assert(!Matrix->checkInterference(VirtReg, BestPhys) &&
+           "Interference after eviction.");
+    return BestPhys;
+  }
+
+  DEBUG(dbgs() << "spilling: " << VirtReg << '\n');
+  if (!VirtReg.isSpillable())
+    return ~0u;
+  ++NumLSSpilled;
+  LiveRangeEdit LRE(&VirtReg, SplitVRegs, *MF, *LIS, VRM);
+  spiller().spill(LRE);
+
+  // The live virtual register requesting allocation was spilled, so tell
+  // the caller not to allocate anything during this round.
+  return 0;
+}
+
+bool RALinearScan::runOnMachineFunction(MachineFunction &mf) {
+  DEBUG(dbgs() << "********** LINEAR SCAN REGISTER ALLOCATION **********\n"
+               << "********** Function: "
+               << mf.getName() << '\n');
+
+  MF = &mf;
+  RegAllocBase::init(getAnalysis<VirtRegMap>(),
+                     getAnalysis<LiveIntervals>(),
+                     getAnalysis<LiveRegMatrix>());
+  SpillerInstance.reset(createInlineSpiller(*this, *MF, *VRM));
+
+  allocatePhysRegs();
+
+  // Diagnostic output before rewriting
+  DEBUG(dbgs() << "Post alloc VirtRegMap:\n" << *VRM << "\n");
+
+  releaseMemory();
+  return true;
+}
+
+FunctionPass* llvm::createLinearScanRegisterAllocator()
+{
+  return new RALinearScan();
+}
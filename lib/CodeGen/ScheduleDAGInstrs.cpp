@@ -17,6 +17,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/CodeGen/LiveIntervalAnalysis.h"
@@ -42,13 +43,26 @@ static cl::opt<bool> EnableAASchedMI("enable-aa-sched-mi", cl::Hidden,
     cl::ZeroOrMore, cl::init(false),
     cl::desc("Enable use of AA during MI GAD construction"));
 
+static cl::opt<unsigned> HugeRegionSize("sched-huge-region", cl::Hidden,
+    cl::init(1000),
+    cl::desc("Use a cheaper memory dependence model for scheduling regions "
+             "with more instructions than this (0 = never)"));
+
+static cl::opt<unsigned> HugeRegionBucketSize("sched-huge-region-bucket",
+    cl::Hidden, cl::init(64),
+    cl::desc("Number of memory operations chained together before a barrier "
+             "is forced in a huge scheduling region"));
+
+STATISTIC(NumHugeRegions, "Number of regions using the huge region DAG model");
+
 ScheduleDAGInstrs::ScheduleDAGInstrs(MachineFunction &mf,
                                      const MachineLoopInfo &mli,
                                      const MachineDominatorTree &mdt,
                                      bool IsPostRAFlag,
                                      LiveIntervals *lis)
   : ScheduleDAG(mf), MLI(mli), MDT(mdt), MFI(mf.getFrameInfo()), LIS(lis),
-    IsPostRA(IsPostRAFlag), CanHandleTerminators(false), FirstDbgValue(0) {
+    IsPostRA(IsPostRAFlag), CanHandleTerminators(false), IsHugeRegion(false),
+    FirstDbgValue(0) {
   assert((IsPostRA || LIS) && "PreRA scheduling requires LiveIntervals");
   DbgValues.clear();
   assert(!(IsPostRA && MRI.getNumVirtRegs()) &&
@@ -642,7 +656,7 @@ void addChainDependency (AliasAnalysis *AA, const MachineFrameInfo *MFI,
                          bool isNormalMemory = false) {
   // If this is a false dependency,
   // do not add the edge, but rememeber the rejected node.
-  if (!EnableAASchedMI ||
+  if (!EnableAASchedMI || !AA ||
       MIsNeedChainEdge(AA, MFI, SUa->getInstr(), SUb->getInstr())) {
     SDep Dep(SUa, isNormalMemory ? SDep::MayAliasMem : SDep::Barrier);
     Dep.setLatency(TrueMemOrderLatency);
@@ -697,6 +711,18 @@ void ScheduleDAGInstrs::buildSchedGraph(AliasAnalysis *AA,
   // Create an SUnit for each real instruction.
   initSUnits();
 
+  // The memory dependencies below can be quadratic in the region size. For
+  // very large regions, don't query alias analysis, and split the memory
+  // operations into buckets by treating every HugeRegionBucketSize'th one as a
+  // barrier. This bounds the number of chain edges added for each operation.
+  IsHugeRegion = HugeRegionSize && SUnits.size() > HugeRegionSize;
+  unsigned NumBucketMemOps = 0;
+  if (IsHugeRegion) {
+    DEBUG(dbgs() << "Huge region with " << SUnits.size() << " instructions\n");
+    ++NumHugeRegions;
+    AA = 0;
+  }
+
   // We build scheduling units by walking a block's instruction list from bottom
   // to top.
 
@@ -799,7 +825,11 @@ void ScheduleDAGInstrs::buildSchedGraph(AliasAnalysis *AA,
     // TODO: Use an AliasAnalysis and do real alias-analysis queries, and
     // produce more precise dependence information.
     unsigned TrueMemOrderLatency = MI->mayStore() ? 1 : 0;
-    if (isGlobalMemoryObject(AA, MI)) {
+    bool IsBucketEnd = IsHugeRegion && (MI->mayLoad() || MI->mayStore()) &&
+                       ++NumBucketMemOps >= HugeRegionBucketSize;
+    if (IsBucketEnd || isGlobalMemoryObject(AA, MI)) {
+      NumBucketMemOps = 0;
+
       // Be conservative with these and add dependencies on all memory
       // references, even those that are known to not alias.
       for (MapVector<const Value *, SUnit *>::iterator I =
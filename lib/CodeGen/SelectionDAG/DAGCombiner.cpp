@@ -18,8 +18,10 @@
 
 #define DEBUG_TYPE "dagcombine"
 #include "llvm/CodeGen/SelectionDAG.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
 #include "llvm/CodeGen/MachineFunction.h"
@@ -30,7 +32,10 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLowering.h"
 #include "llvm/Target/TargetMachine.h"
@@ -53,6 +58,68 @@ namespace {
     CombinerGlobalAA("combiner-global-alias-analysis", cl::Hidden,
                cl::desc("Include global information in alias analysis"));
 
+  static cl::opt<bool>
+    DAGCombineStats("dag-combine-stats", cl::Hidden,
+               cl::desc("Print how often each opcode was combined"));
+
+  /// CombineCounts - Number of times nodes with one opcode were handed to
+  /// the combiner, and how many of those were changed.
+  struct CombineCounts {
+    unsigned Attempts;
+    unsigned Hits;
+    CombineCounts() : Attempts(0), Hits(0) {}
+  };
+
+  /// CombineStatsReport - Totals of every DAGCombiner run in the process,
+  /// keyed by opcode name.  The report is printed when it is destroyed at
+  /// llvm_shutdown.
+  class CombineStatsReport {
+    sys::SmartMutex<true> Lock;
+    StringMap<CombineCounts> Counts;
+
+    struct AttemptsCompare {
+      bool operator()(const StringMapEntry<CombineCounts> *LHS,
+                      const StringMapEntry<CombineCounts> *RHS) const {
+        if (LHS->getValue().Attempts != RHS->getValue().Attempts)
+          return LHS->getValue().Attempts > RHS->getValue().Attempts;
+        return LHS->getKey() < RHS->getKey();
+      }
+    };
+
+  public:
+    void add(StringRef Name, const CombineCounts &C) {
+      sys::SmartScopedLock<true> Guard(Lock);
+      CombineCounts &Total = Counts[Name];
+      Total.Attempts += C.Attempts;
+      Total.Hits += C.Hits;
+    }
+
+    ~CombineStatsReport() {
+      if (Counts.empty())
+        return;
+
+      std::vector<const StringMapEntry<CombineCounts>*> Entries;
+      for (StringMap<CombineCounts>::const_iterator I = Counts.begin(),
+           E = Counts.end(); I != E; ++I)
+        Entries.push_back(&*I);
+      std::sort(Entries.begin(), Entries.end(), AttemptsCompare());
+
+      raw_ostream &OS = errs();
+      OS << "===" << std::string(73, '-') << "===\n"
+         << "                        ... DAG Combine Statistics ...\n"
+         << "===" << std::string(73, '-') << "===\n\n"
+         << "  Attempts      Hits  Opcode\n";
+      for (unsigned i = 0, e = Entries.size(); i != e; ++i)
+        OS << format("%10u %9u  ", Entries[i]->getValue().Attempts,
+                     Entries[i]->getValue().Hits)
+           << Entries[i]->getKey() << '\n';
+      OS << '\n';
+      OS.flush();
+    }
+  };
+
+  static ManagedStatic<CombineStatsReport> CombineStats;
+
 //------------------------------ DAGCombiner ---------------------------------//
 
   class DAGCombiner {
@@ -67,21 +134,19 @@ namespace {
     //
     // This has the semantics that when adding to the worklist,
     // the item added must be next to be processed. It should
-    // also only appear once. The naive approach to this takes
-    // linear time.
-    //
-    // To reduce the insert/remove time to logarithmic, we use
-    // a set and a vector to maintain our worklist.
+    // also only appear once.
     //
-    // The set contains the items on the worklist, but does not
-    // maintain the order they should be visited.
-    //
-    // The vector maintains the order nodes should be visited, but may
-    // contain duplicate or removed nodes. When choosing a node to
-    // visit, we pop off the order stack until we find an item that is
-    // also in the contents set. All operations are O(log N).
-    SmallPtrSet<SDNode*, 64> WorkListContents;
-    SmallVector<SDNode*, 64> WorkListOrder;
+    // Each node on the worklist records its position in the vector, so
+    // membership tests are free.  Re-adding or removing a node clears its
+    // old slot, and empty slots are skipped when choosing the next node to
+    // visit.  All operations are O(1).
+    SmallVector<SDNode*, 64> WorkList;
+    unsigned WorkListSize;
+
+    // Per-opcode counts of combine attempts and successes, kept only with
+    // -dag-combine-stats.  The name is recorded with the first node seen so
+    // that target opcodes can be reported too.
+    DenseMap<unsigned, std::pair<std::string, CombineCounts> > OpcodeStats;
 
     // AA - Used for DAG load/store alias analysis.
     AliasAnalysis &AA;
@@ -104,14 +169,35 @@ namespace {
     /// AddToWorkList - Add to the work list making sure its instance is at the
     /// back (next to be processed.)
     void AddToWorkList(SDNode *N) {
-      WorkListContents.insert(N);
-      WorkListOrder.push_back(N);
+      int Index = N->getCombinerWorklistIndex();
+      if (Index >= 0)
+        WorkList[Index] = 0;
+      else
+        ++WorkListSize;
+      N->setCombinerWorklistIndex(WorkList.size());
+      WorkList.push_back(N);
     }
 
-    /// removeFromWorkList - remove all instances of N from the worklist.
+    /// removeFromWorkList - remove N from the worklist.
     ///
     void removeFromWorkList(SDNode *N) {
-      WorkListContents.erase(N);
+      int Index = N->getCombinerWorklistIndex();
+      if (Index < 0)
+        return;
+      WorkList[Index] = 0;
+      N->setCombinerWorklistIndex(-1);
+      --WorkListSize;
+    }
+
+    /// getNextWorkListEntry - Pop the next node to visit off the worklist.
+    SDNode *getNextWorkListEntry() {
+      SDNode *N;
+      do
+        N = WorkList.pop_back_val();
+      while (!N);
+      N->setCombinerWorklistIndex(-1);
+      --WorkListSize;
+      return N;
     }
 
     SDValue CombineTo(SDNode *N, const SDValue *To, unsigned NumTo,
@@ -316,7 +402,14 @@ namespace {
   public:
     DAGCombiner(SelectionDAG &D, AliasAnalysis &A, CodeGenOpt::Level OL)
       : DAG(D), TLI(D.getTargetLoweringInfo()), Level(BeforeLegalizeTypes),
-        OptLevel(OL), LegalOperations(false), LegalTypes(false), AA(A) {}
+        OptLevel(OL), LegalOperations(false), LegalTypes(false),
+        WorkListSize(0), AA(A) {}
+
+    ~DAGCombiner() {
+      for (DenseMap<unsigned, std::pair<std::string, CombineCounts> >::iterator
+           I = OpcodeStats.begin(), E = OpcodeStats.end(); I != E; ++I)
+        CombineStats->add(I->second.first, I->second.second);
+    }
 
     /// Run - runs the dag combiner on all nodes in the work list
     void Run(CombineLevel AtLevel);
@@ -1006,15 +1099,8 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
 
   // while the worklist isn't empty, find a node and
   // try and combine it.
-  while (!WorkListContents.empty()) {
-    SDNode *N;
-    // The WorkListOrder holds the SDNodes in order, but it may contain duplicates.
-    // In order to avoid a linear scan, we use a set (O(log N)) to hold what the
-    // worklist *should* contain, and check the node we want to visit is should
-    // actually be visited.
-    do {
-      N = WorkListOrder.pop_back_val();
-    } while (!WorkListContents.erase(N));
+  while (WorkListSize) {
+    SDNode *N = getNextWorkListEntry();
 
     // If N has no uses, it is dead.  Make sure to revisit all N's operands once
     // N is deleted from the DAG, since they too may now be dead or may have a
@@ -1027,11 +1113,24 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
       continue;
     }
 
+    CombineCounts *Counts = 0;
+    if (DAGCombineStats) {
+      std::pair<std::string, CombineCounts> &Entry =
+        OpcodeStats[N->getOpcode()];
+      if (Entry.first.empty())
+        Entry.first = N->getOperationName(&DAG);
+      Counts = &Entry.second;
+      ++Counts->Attempts;
+    }
+
     SDValue RV = combine(N);
 
     if (RV.getNode() == 0)
       continue;
 
+    if (Counts)
+      ++Counts->Hits;
+
     ++NodesCombined;
 
     // If we get back the same node we passed in, rather than a new node or
@@ -1007,6 +1007,26 @@ void SelectionDAGBuilder::resolveDanglingDebugInfo(const Value *V,
   }
 }
 
+void SelectionDAGBuilder::LowerDbgValueBeforeCut(const DbgValueInst &DI) {
+  MDNode *Variable = DI.getVariable();
+  const Value *V = DI.getValue();
+  if (!V || !DIVariable(Variable).Verify())
+    return;
+
+  SDValue N = NodeMap.lookup(V);
+  if (!N.getNode() && isa<Argument>(V))
+    N = UnusedArgNodeMap.lookup(V);
+  if (!N.getNode())
+    return;
+
+  uint64_t Offset = DI.getOffset();
+  if (!EmitFuncArgumentDbgValue(V, Variable, Offset, N)) {
+    SDDbgValue *SDV = DAG.getDbgValue(Variable, N.getNode(), N.getResNo(),
+                                      Offset, DI.getDebugLoc(), ++SDNodeOrder);
+    DAG.AddDbgValue(SDV, N.getNode(), false);
+  }
+}
+
 /// getValue - Return an SDValue for the given Value.
 SDValue SelectionDAGBuilder::getValue(const Value *V) {
   // If we already have an SDValue for this value, use it. It's important
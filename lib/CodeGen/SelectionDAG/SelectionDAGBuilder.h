@@ -382,6 +382,13 @@ public:
   // resolveDanglingDebugInfo - if we saw an earlier dbg_value referring to V,
   // generate the debug data structures now that we've seen its definition.
   void resolveDanglingDebugInfo(const Value *V, SDValue Val);
+
+  /// LowerDbgValueBeforeCut - DI comes after the point where the current
+  /// block is cut into another DAG.  If its value is computed by the
+  /// current DAG, describe the variable with that node now, since the node
+  /// will be gone by the time DI itself is lowered.
+  void LowerDbgValueBeforeCut(const DbgValueInst &DI);
+
   SDValue getValue(const Value *V);
   SDValue getNonRegisterValue(const Value *V);
   SDValue getValueImpl(const Value *V);
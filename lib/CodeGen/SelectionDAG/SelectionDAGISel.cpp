@@ -64,6 +64,10 @@ STATISTIC(NumFastIselBlocks, "Number of blocks selected entirely by fast isel");
 STATISTIC(NumDAGBlocks, "Number of blocks selected using DAG");
 STATISTIC(NumDAGIselRetries,"Number of times dag isel has to try another path");
 STATISTIC(NumEntryBlocks, "Number of entry blocks encountered");
+STATISTIC(NumDAGSplitBlocks,
+          "Number of blocks split into several DAGs to bound their size");
+STATISTIC(NumDAGSplitRegions,
+          "Number of extra DAGs created by splitting large blocks");
 STATISTIC(NumFastIselFailLowerArguments,
           "Number of entry blocks where fast isel failed to lower arguments");
 
@@ -155,6 +159,11 @@ EnableFastISelAbortArgs("fast-isel-abort-args", cl::Hidden,
           cl::desc("Enable abort calls when \"fast\" instruction selection "
                    "fails to lower a formal argument"));
 
+static cl::opt<unsigned>
+DAGNodeLimit("dag-block-node-limit", cl::Hidden, cl::init(0),
+          cl::desc("Select blocks whose DAG grows beyond this many nodes as "
+                   "several smaller DAGs (0 = no limit)"));
+
 static cl::opt<bool>
 UseMBPI("use-mbpi",
         cl::desc("use Machine Branch Probability Info"),
@@ -507,14 +516,157 @@ bool SelectionDAGISel::runOnMachineFunction(MachineFunction &mf) {
   return true;
 }
 
+/// FindLastSplitPoint - Return the first instruction in [Begin, End) that
+/// has to be lowered in the same DAG as the block's terminator.  Branch
+/// lowering looks through and/or trees of conditions in the same block and
+/// folds their compares into the branches, which needs the operands of the
+/// compares.  Those are not otherwise copied out of an earlier DAG.
+static BasicBlock::const_iterator
+FindLastSplitPoint(BasicBlock::const_iterator Begin,
+                   BasicBlock::const_iterator End) {
+  const BasicBlock *BB = Begin->getParent();
+  if (End != BB->end())
+    return End;
+
+  const TerminatorInst *TI = BB->getTerminator();
+  SmallPtrSet<const Instruction*, 8> Pinned;
+  SmallVector<const Instruction*, 8> Worklist;
+  Pinned.insert(TI);
+  Worklist.push_back(TI);
+  while (!Worklist.empty()) {
+    const Instruction *I = Worklist.pop_back_val();
+    for (User::const_op_iterator OI = I->op_begin(), OE = I->op_end();
+         OI != OE; ++OI) {
+      const Instruction *Op = dyn_cast<Instruction>(*OI);
+      if (!Op || Op->getParent() != BB || !Pinned.insert(Op))
+        continue;
+      // Compares only contribute their operands, while the operands of an
+      // and/or are conditions in their own right.
+      if (isa<CmpInst>(I))
+        continue;
+      if (isa<CmpInst>(Op) ||
+          (isa<BinaryOperator>(Op) && (Op->getOpcode() == Instruction::And ||
+                                       Op->getOpcode() == Instruction::Or)))
+        Worklist.push_back(Op);
+    }
+  }
+
+  for (BasicBlock::const_iterator I = Begin; I != End; ++I)
+    if (Pinned.count(I))
+      return I;
+  return End;
+}
+
+/// isUsedLaterInBlock - Return true if V has a user in BB, other than a PHI
+/// node, that is not in Region.
+static bool isUsedLaterInBlock(const Value *V, const BasicBlock *BB,
+                               const SmallPtrSet<const Instruction*, 64> &Region) {
+  for (Value::const_use_iterator UI = V->use_begin(), UE = V->use_end();
+       UI != UE; ++UI) {
+    const Instruction *User = cast<Instruction>(*UI);
+    if (User->getParent() == BB && !isa<PHINode>(User) && !Region.count(User))
+      return true;
+  }
+  return false;
+}
+
+/// ExportValuesUsedLater - Copy the values defined in [Begin, End) that are
+/// used further down the same block into virtual registers, so that they are
+/// available to the DAGs built for the rest of the block.  Values used in
+/// other blocks have registers already and were copied out when they were
+/// lowered.  When the first region of the entry block is cut off, the same
+/// goes for the function's arguments.
+///
+/// A llvm.dbg.value further down is not a use, and exporting its value would
+/// make the generated code depend on the debug info.  Instead, the variable
+/// is attached to the node that computes the value before the cut drops it.
+static void ExportValuesUsedLater(BasicBlock::const_iterator Begin,
+                                  BasicBlock::const_iterator End,
+                                  bool FirstRegion,
+                                  FunctionLoweringInfo &FuncInfo,
+                                  SelectionDAGBuilder &SDB) {
+  const BasicBlock *BB = Begin->getParent();
+  SmallPtrSet<const Instruction*, 64> Region;
+  for (BasicBlock::const_iterator I = Begin; I != End; ++I)
+    Region.insert(I);
+
+  if (FirstRegion && BB == &BB->getParent()->getEntryBlock()) {
+    const Function *F = BB->getParent();
+    for (Function::const_arg_iterator AI = F->arg_begin(), AE = F->arg_end();
+         AI != AE; ++AI)
+      if (!AI->getType()->isEmptyTy() && !FuncInfo.ValueMap.count(AI) &&
+          isUsedLaterInBlock(AI, BB, Region))
+        SDB.CopyValueToVirtualRegister(AI, FuncInfo.InitializeRegForValue(AI));
+  }
+
+  for (BasicBlock::const_iterator I = Begin; I != End; ++I) {
+    if (I->use_empty() || I->getType()->isEmptyTy() ||
+        FuncInfo.ValueMap.count(I))
+      continue;
+    // Static allocas are referred to through their frame index.
+    if (const AllocaInst *AI = dyn_cast<AllocaInst>(I))
+      if (FuncInfo.StaticAllocaMap.count(AI))
+        continue;
+    if (isUsedLaterInBlock(I, BB, Region))
+      SDB.CopyValueToVirtualRegister(I, FuncInfo.InitializeRegForValue(I));
+  }
+
+  for (BasicBlock::const_iterator I = End, E = BB->end(); I != E; ++I) {
+    const DbgValueInst *DI = dyn_cast<DbgValueInst>(I);
+    if (!DI || !DI->getValue())
+      continue;
+    const Value *V = DI->getValue();
+    const Instruction *Def = dyn_cast<Instruction>(V);
+    if ((Def && Region.count(Def)) || isa<Argument>(V))
+      SDB.LowerDbgValueBeforeCut(*DI);
+  }
+}
+
 void SelectionDAGISel::SelectBasicBlock(BasicBlock::const_iterator Begin,
                                         BasicBlock::const_iterator End,
                                         bool &HadTailCall) {
+  // With -dag-block-node-limit, a block whose DAG grows too large is cut
+  // into regions that are each built, legalized, selected and scheduled on
+  // their own.  The cost of the superlinear parts of the pipeline then
+  // grows with the size of the regions rather than the size of the block,
+  // at the price of optimizations that would have crossed a cut.  Counting
+  // the nodes walks the whole DAG, so this is only done every few
+  // instructions.
+  BasicBlock::const_iterator LastSplit = End;
+  unsigned CheckInterval = 0, SinceCheck = 0;
+  if (DAGNodeLimit) {
+    LastSplit = FindLastSplitPoint(Begin, End);
+    CheckInterval = std::max(DAGNodeLimit / 16, 1U);
+  }
+  BasicBlock::const_iterator RegionBegin = Begin;
+  bool WasSplit = false;
+
   // Lower all of the non-terminator instructions. If a call is emitted
   // as a tail call, cease emitting nodes for this block. Terminators
   // are handled below.
-  for (BasicBlock::const_iterator I = Begin; I != End && !SDB->HasTailCall; ++I)
+  for (BasicBlock::const_iterator I = Begin; I != End && !SDB->HasTailCall;) {
+    if (I == LastSplit)
+      CheckInterval = 0;
     SDB->visit(*I);
+    ++I;
+
+    if (!CheckInterval || SDB->HasTailCall || ++SinceCheck < CheckInterval)
+      continue;
+    SinceCheck = 0;
+    if (CurDAG->allnodes_size() < DAGNodeLimit)
+      continue;
+
+    // Emit what has been lowered so far as a DAG of its own.
+    ExportValuesUsedLater(RegionBegin, I, !WasSplit, *FuncInfo, *SDB);
+    CurDAG->setRoot(SDB->getControlRoot());
+    SDB->clear();
+    CodeGenAndEmitDAG();
+    RegionBegin = I;
+    WasSplit = true;
+    ++NumDAGSplitRegions;
+  }
+  if (WasSplit)
+    ++NumDAGSplitBlocks;
 
   // Make sure the root of the DAG is up-to-date.
   CurDAG->setRoot(SDB->getControlRoot());
@@ -2134,9 +2286,50 @@ struct MatchScope {
 
 }
 
+/// getRootMatcherIndex - Return the index in MatcherTable at which matching a
+/// node with the given opcode should start.  Normally this is opcode #0, but if
+/// the state machine starts with an OPC_SwitchOpcode, then we accelerate the
+/// first lookup (which is guaranteed to be hot) with the OpcodeOffset table.
+unsigned SelectionDAGISel::
+getRootMatcherIndex(unsigned Opcode, const unsigned char *MatcherTable) {
+  if (OpcodeOffset.empty() && MatcherTable[0] == OPC_SwitchOpcode) {
+    // The table isn't computed, but the state machine does start with an
+    // OPC_SwitchOpcode instruction.  Populate the table now, since this is the
+    // first time we're selecting an instruction.
+    unsigned Idx = 1;
+    while (1) {
+      // Get the size of this case.
+      unsigned CaseSize = MatcherTable[Idx++];
+      if (CaseSize & 128)
+        CaseSize = GetVBR(CaseSize, MatcherTable, Idx);
+      if (CaseSize == 0) break;
+
+      // Get the opcode, add the index to the table.
+      uint16_t Opc = MatcherTable[Idx++];
+      Opc |= (unsigned short)MatcherTable[Idx++] << 8;
+      if (Opc >= OpcodeOffset.size())
+        OpcodeOffset.resize((Opc+1)*2);
+      OpcodeOffset[Opc] = Idx;
+      Idx += CaseSize;
+    }
+  }
+
+  if (Opcode < OpcodeOffset.size())
+    return OpcodeOffset[Opcode];
+  return 0;
+}
+
 SDNode *SelectionDAGISel::
 SelectCodeCommon(SDNode *NodeToMatch, const unsigned char *MatcherTable,
                  unsigned TableSize) {
+  return SelectCodeCommon(NodeToMatch, MatcherTable, TableSize,
+                          getRootMatcherIndex(NodeToMatch->getOpcode(),
+                                              MatcherTable));
+}
+
+SDNode *SelectionDAGISel::
+SelectCodeCommon(SDNode *NodeToMatch, const unsigned char *MatcherTable,
+                 unsigned TableSize, unsigned MatcherIndex) {
   // FIXME: Should these even be selected?  Handle these cases in the caller?
   switch (NodeToMatch->getOpcode()) {
   default:
@@ -2211,43 +2404,9 @@ SelectCodeCommon(SDNode *NodeToMatch, const unsigned char *MatcherTable,
         NodeToMatch->dump(CurDAG);
         dbgs() << '\n');
 
-  // Determine where to start the interpreter.  Normally we start at opcode #0,
-  // but if the state machine starts with an OPC_SwitchOpcode, then we
-  // accelerate the first lookup (which is guaranteed to be hot) with the
-  // OpcodeOffset table.
-  unsigned MatcherIndex = 0;
-
-  if (!OpcodeOffset.empty()) {
-    // Already computed the OpcodeOffset table, just index into it.
-    if (N.getOpcode() < OpcodeOffset.size())
-      MatcherIndex = OpcodeOffset[N.getOpcode()];
-    DEBUG(dbgs() << "  Initial Opcode index to " << MatcherIndex << "\n");
-
-  } else if (MatcherTable[0] == OPC_SwitchOpcode) {
-    // Otherwise, the table isn't computed, but the state machine does start
-    // with an OPC_SwitchOpcode instruction.  Populate the table now, since this
-    // is the first time we're selecting an instruction.
-    unsigned Idx = 1;
-    while (1) {
-      // Get the size of this case.
-      unsigned CaseSize = MatcherTable[Idx++];
-      if (CaseSize & 128)
-        CaseSize = GetVBR(CaseSize, MatcherTable, Idx);
-      if (CaseSize == 0) break;
-
-      // Get the opcode, add the index to the table.
-      uint16_t Opc = MatcherTable[Idx++];
-      Opc |= (unsigned short)MatcherTable[Idx++] << 8;
-      if (Opc >= OpcodeOffset.size())
-        OpcodeOffset.resize((Opc+1)*2);
-      OpcodeOffset[Opc] = Idx;
-      Idx += CaseSize;
-    }
-
-    // Okay, do the lookup for the first opcode.
-    if (N.getOpcode() < OpcodeOffset.size())
-      MatcherIndex = OpcodeOffset[N.getOpcode()];
-  }
+  // The caller has already found where the interpreter should start for this
+  // opcode.
+  DEBUG(dbgs() << "  Initial Opcode index to " << MatcherIndex << "\n");
 
   while (1) {
     assert(MatcherIndex < TableSize && "Invalid index");
@@ -24,6 +24,7 @@ INITIALIZE_PASS(SlotIndexes, "slotindexes",
 
 STATISTIC(NumLocalRenum,  "Number of local renumberings");
 STATISTIC(NumGlobalRenum, "Number of global renumberings");
+STATISTIC(NumRenumEntries, "Number of index entries renumbered locally");
 
 void SlotIndexes::getAnalysisUsage(AnalysisUsage &au) const {
   au.setPreservesAll();
@@ -62,7 +63,9 @@ bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
   assert(mi2iMap.empty() &&
          "MachineInstr -> Index mapping non-empty at initial numbering?");
 
-  unsigned index = 0;
+  const uint64_t Space = uint64_t(SlotIndex::InstrDist) <<
+                         SlotIndex::IndexShift;
+  uint64_t index = 0;
   MBBRanges.resize(mf->getNumBlockIDs());
   idx2MBBMap.reserve(mf->size());
 
@@ -83,7 +86,7 @@ bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
         continue;
 
       // Insert a store index for the instr.
-      indexList.push_back(createEntry(mi, index += SlotIndex::InstrDist));
+      indexList.push_back(createEntry(mi, index += Space));
 
       // Save this base index in the maps.
       mi2iMap.insert(std::make_pair(mi, SlotIndex(&indexList.back(),
@@ -91,7 +94,7 @@ bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
     }
 
     // We insert one blank instructions between basic blocks.
-    indexList.push_back(createEntry(0, index += SlotIndex::InstrDist));
+    indexList.push_back(createEntry(0, index += Space));
 
     MBBRanges[mbb->getNumber()].first = blockStartIndex;
     MBBRanges[mbb->getNumber()].second = SlotIndex(&indexList.back(),
@@ -113,33 +116,63 @@ void SlotIndexes::renumberIndexes() {
   DEBUG(dbgs() << "\n*** Renumbering SlotIndexes ***\n");
   ++NumGlobalRenum;
 
-  unsigned index = 0;
+  const uint64_t Space = uint64_t(SlotIndex::InstrDist) <<
+                         SlotIndex::IndexShift;
+  uint64_t index = 0;
 
   for (IndexList::iterator I = indexList.begin(), E = indexList.end();
        I != E; ++I) {
     I->setIndex(index);
-    index += SlotIndex::InstrDist;
+    index += Space;
   }
 }
 
 // Renumber indexes locally after curItr was inserted, but failed to get a new
 // index.
+//
+// This is the order maintenance scheme of Bender et al.: find the smallest
+// window around curItr whose entries are sparse enough, and spread them evenly
+// between the indexes of the two entries bounding it.  The window doubles in
+// size at each level, and the spacing required of it doubles too, so a
+// renumbered window leaves plenty of room for further insertions in any part
+// of it.  This keeps the amortized cost of an insertion constant.  A window
+// that reaches the end of the list is renumbered with the default spacing.
 void SlotIndexes::renumberIndexes(IndexList::iterator curItr) {
-  // Number indexes with half the default spacing so we can catch up quickly.
-  const unsigned Space = SlotIndex::InstrDist/2;
-  assert((Space & 3) == 0 && "InstrDist must be a multiple of 2*NUM");
-
+  const uint64_t DefaultSpace = uint64_t(SlotIndex::InstrDist) <<
+                                SlotIndex::IndexShift;
   IndexList::iterator startItr = prior(curItr);
-  unsigned index = startItr->getIndex();
-  do {
-    curItr->setIndex(index += Space);
-    ++curItr;
-    // If the next index is bigger, we have caught up.
-  } while (curItr != indexList.end() && curItr->getIndex() <= index);
-
-  DEBUG(dbgs() << "\n*** Renumbered SlotIndexes " << startItr->getIndex() << '-'
-               << index << " ***\n");
+  IndexList::iterator endItr = llvm::next(curItr);
+  uint64_t NumEntries = 1;
+  uint64_t Space = DefaultSpace;
+  for (unsigned Level = 0; endItr != indexList.end(); ++Level) {
+    uint64_t MinSpace = std::min(uint64_t(4) << std::min(Level, 32u),
+                                 DefaultSpace);
+    uint64_t Range = endItr->getIndex() - startItr->getIndex();
+    if (Range / (NumEntries + 1) >= MinSpace) {
+      Space = (Range / (NumEntries + 1)) & ~3ull;
+      break;
+    }
+
+    // Double the window, growing it in both directions where possible.
+    uint64_t Grow = std::max<uint64_t>(NumEntries / 2, 1);
+    for (uint64_t i = 0; i != Grow && startItr != indexList.begin(); ++i) {
+      --startItr;
+      ++NumEntries;
+    }
+    for (uint64_t i = 0; i != Grow && endItr != indexList.end(); ++i) {
+      ++endItr;
+      ++NumEntries;
+    }
+  }
+  assert(Space >= 4 && (Space & 3) == 0 && "Invalid index spacing");
+
+  uint64_t index = startItr->getIndex();
+  for (IndexList::iterator I = llvm::next(startItr); I != endItr; ++I)
+    I->setIndex(index += Space);
+
+  DEBUG(dbgs() << "\n*** Renumbered " << NumEntries << " SlotIndexes ***\n");
   ++NumLocalRenum;
+  NumRenumEntries += NumEntries;
 }
 
 // Repair indexes after adding and removing instructions.
@@ -217,7 +250,7 @@ void SlotIndexes::repairIndexesInRange(MachineBasicBlock *MBB,
 void SlotIndexes::dump() const {
   for (IndexList::const_iterator itr = indexList.begin();
        itr != indexList.end(); ++itr) {
-    dbgs() << itr->getIndex() << " ";
+    dbgs() << (itr->getIndex() >> SlotIndex::IndexShift) << " ";
 
     if (itr->getInstr() != 0) {
       dbgs() << *itr->getInstr();
@@ -235,7 +268,7 @@ void SlotIndexes::dump() const {
 // Print a SlotIndex to a raw_ostream.
 void SlotIndex::print(raw_ostream &os) const {
   if (isValid())
-    os << listEntry()->getIndex() << "Berd"[getSlot()];
+    os << (listEntry()->getIndex() >> IndexShift) << "Berd"[getSlot()];
   else
     os << "invalid";
 }
@@ -68,6 +68,7 @@ bool TargetOptions::operator==(const TargetOptions &TO) {
     ARE_EQUAL(RealignStack) &&
     ARE_EQUAL(SSPBufferSize) &&
     ARE_EQUAL(EnableFastISel) &&
+    ARE_EQUAL(UseLinearScanRegAlloc) &&
     ARE_EQUAL(PositionIndependentExecutable) &&
     ARE_EQUAL(EnableSegmentedStacks) &&
     ARE_EQUAL(UseInitArray) &&
@@ -49,12 +49,8 @@ namespace {
         Range.LoPC = ArangeDescPtr->Address;
         Range.Length = ArangeDescPtr->Length;
 
-        // Insert each item in increasing address order so binary searching
-        // can later be done!
-        DWARFDebugAranges::RangeColl::iterator InsertPos =
-          std::lower_bound(RangeCollection.begin(), RangeCollection.end(),
-                           Range, RangeLessThan);
-        RangeCollection.insert(InsertPos, Range);
+        // The collection is sorted once all ranges have been added.
+        RangeCollection.push_back(Range);
       }
 
     }
@@ -83,6 +79,7 @@ bool DWARFDebugAranges::extract(DataExtractor debug_aranges_data) {
       Aranges.reserve(count);
       AddArangeDescriptors range_adder(Aranges, ParsedCUOffsets);
       std::for_each(sets.begin(), sets.end(), range_adder);
+      sort(false, 0);
     }
   }
   return false;
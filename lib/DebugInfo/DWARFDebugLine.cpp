@@ -7,7 +7,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#define DEBUG_TYPE "dwarf"
 #include "DWARFDebugLine.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Dwarf.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
@@ -16,6 +18,9 @@
 using namespace llvm;
 using namespace dwarf;
 
+STATISTIC(NumLineTablesParsed, "Number of line tables parsed");
+STATISTIC(NumLineTablesEvicted, "Number of line tables dropped from the cache");
+
 void DWARFDebugLine::Prologue::dump(raw_ostream &OS) const {
   OS << "Line table prologue:\n"
      << format("   total_length: 0x%8.8x\n", TotalLength)
@@ -93,6 +98,14 @@ void DWARFDebugLine::LineTable::dump(raw_ostream &OS) const {
   }
 }
 
+uint64_t DWARFDebugLine::LineTable::getMemorySize() const {
+  return sizeof(*this) + Rows.capacity() * sizeof(Row) +
+         Sequences.capacity() * sizeof(Sequence) +
+         Prologue.StandardOpcodeLengths.capacity() * sizeof(uint8_t) +
+         Prologue.IncludeDirectories.capacity() * sizeof(const char *) +
+         Prologue.FileNames.capacity() * sizeof(FileNameEntry);
+}
+
 DWARFDebugLine::State::~State() {}
 
 void DWARFDebugLine::State::appendRowToMatrix(uint32_t offset) {
@@ -142,8 +155,10 @@ void DWARFDebugLine::DumpingState::finalize() {
 const DWARFDebugLine::LineTable *
 DWARFDebugLine::getLineTable(uint32_t offset) const {
   LineTableConstIter pos = LineTableMap.find(offset);
-  if (pos != LineTableMap.end())
-    return &pos->second;
+  if (pos != LineTableMap.end()) {
+    touch(pos->second);
+    return &pos->second.Table;
+  }
   return 0;
 }
 
@@ -151,15 +166,39 @@ const DWARFDebugLine::LineTable *
 DWARFDebugLine::getOrParseLineTable(DataExtractor debug_line_data,
                                     uint32_t offset) {
   std::pair<LineTableIter, bool> pos =
-    LineTableMap.insert(LineTableMapTy::value_type(offset, LineTable()));
-  if (pos.second) {
-    // Parse and cache the line table for at this offset.
-    State state;
-    if (!parseStatementTable(debug_line_data, RelocMap, &offset, state))
-      return 0;
-    pos.first->second = state;
+    LineTableMap.insert(LineTableMapTy::value_type(offset, CachedLineTable()));
+  CachedLineTable &Entry = pos.first->second;
+  if (!pos.second) {
+    touch(Entry);
+    return &Entry.Table;
+  }
+
+  // Parse and cache the line table for at this offset.
+  State state;
+  if (!parseStatementTable(debug_line_data, RelocMap, &offset, state)) {
+    LineTableMap.erase(pos.first);
+    return 0;
+  }
+  ++NumLineTablesParsed;
+  Entry.Table = state;
+  Entry.Size = Entry.Table.getMemorySize();
+  Entry.LRUPos = LRUList.insert(LRUList.begin(), pos.first->first);
+  CacheSize += Entry.Size;
+  pruneCache();
+  return &Entry.Table;
+}
+
+void DWARFDebugLine::pruneCache() {
+  if (MaxCacheSize == 0)
+    return;
+  while (CacheSize > MaxCacheSize && LRUList.size() > 1) {
+    LineTableIter Victim = LineTableMap.find(LRUList.back());
+    assert(Victim != LineTableMap.end() && "LRU list out of sync with cache");
+    CacheSize -= Victim->second.Size;
+    LineTableMap.erase(Victim);
+    LRUList.pop_back();
+    ++NumLineTablesEvicted;
   }
-  return &pos.first->second;
 }
 
 bool
@@ -12,6 +12,7 @@
 
 #include "DWARFRelocMap.h"
 #include "llvm/Support/DataExtractor.h"
+#include <list>
 #include <map>
 #include <string>
 #include <vector>
@@ -22,7 +23,12 @@ class raw_ostream;
 
 class DWARFDebugLine {
 public:
-  DWARFDebugLine(const RelocAddrMap* LineInfoRelocMap) : RelocMap(LineInfoRelocMap) {}
+  /// Parsed line tables are cached. If MaxCacheSize is non-zero, the least
+  /// recently used tables are dropped once the cached tables take up more than
+  /// MaxCacheSize bytes.
+  DWARFDebugLine(const RelocAddrMap* LineInfoRelocMap,
+                 uint64_t MaxCacheSize = 0)
+    : RelocMap(LineInfoRelocMap), MaxCacheSize(MaxCacheSize), CacheSize(0) {}
   struct FileNameEntry {
     FileNameEntry() : Name(0), DirIdx(0), ModTime(0), Length(0) {}
 
@@ -190,6 +196,9 @@ public:
 
     void dump(raw_ostream &OS) const;
 
+    // Returns the approximate number of bytes of memory held by the table.
+    uint64_t getMemorySize() const;
+
     struct Prologue Prologue;
     typedef std::vector<Row> RowVector;
     typedef RowVector::const_iterator RowIter;
@@ -236,17 +245,41 @@ public:
                                   const RelocAddrMap *RMap,
                                   uint32_t *offset_ptr, State &state);
 
+  // Returns the cached line table at the given offset, or null. The returned
+  // table stays valid until a table at another offset is parsed.
   const LineTable *getLineTable(uint32_t offset) const;
   const LineTable *getOrParseLineTable(DataExtractor debug_line_data,
                                        uint32_t offset);
 
 private:
-  typedef std::map<uint32_t, LineTable> LineTableMapTy;
+  /// Offsets of the cached tables, most recently used first.
+  typedef std::list<uint32_t> LRUListTy;
+
+  struct CachedLineTable {
+    CachedLineTable() : Size(0) {}
+    LineTable Table;
+    uint64_t Size;
+    /// This table's position in LRUList.
+    LRUListTy::iterator LRUPos;
+  };
+  typedef std::map<uint32_t, CachedLineTable> LineTableMapTy;
   typedef LineTableMapTy::iterator LineTableIter;
   typedef LineTableMapTy::const_iterator LineTableConstIter;
 
+  /// Marks the table as the most recently used one.
+  void touch(const CachedLineTable &Entry) const {
+    LRUList.splice(LRUList.begin(), LRUList, Entry.LRUPos);
+  }
+
+  /// Drops the least recently used tables, other than the most recently used
+  /// one, until the cache fits in MaxCacheSize.
+  void pruneCache();
+
   const RelocAddrMap *RelocMap;
   LineTableMapTy LineTableMap;
+  mutable LRUListTy LRUList;
+  uint64_t MaxCacheSize;
+  uint64_t CacheSize;
 };
 
 }
@@ -65,3 +65,14 @@ bool DWARFDebugRangeList::containsAddress(uint64_t BaseAddress,
   }
   return false;
 }
+
+void DWARFDebugRangeList::getAbsoluteRanges(uint64_t BaseAddress,
+                std::vector<std::pair<uint64_t, uint64_t> > &Ranges) const {
+  for (int i = 0, n = Entries.size(); i != n; ++i) {
+    if (Entries[i].isBaseAddressSelectionEntry(AddressSize))
+      BaseAddress = Entries[i].EndAddress;
+    else if (Entries[i].StartAddress < Entries[i].EndAddress)
+      Ranges.push_back(std::make_pair(BaseAddress + Entries[i].StartAddress,
+                                      BaseAddress + Entries[i].EndAddress));
+  }
+}
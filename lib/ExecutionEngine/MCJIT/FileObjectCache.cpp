@@ -0,0 +1,211 @@
+//===- FileObjectCache.cpp - On-disk object cache for MCJIT ---------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the file-backed object cache.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/FileObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitcode/ReaderWriter.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/LockFileManager.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace llvm;
+
+namespace {
+
+/// Hasher - 64-bit FNV-1a.  The key has to be identical across runs and
+/// hosts, so this deliberately does not use llvm::hash_value, whose seed may
+/// change between executions.
+class Hasher {
+  uint64_t Hash;
+
+public:
+  Hasher() : Hash(14695981039346656037ULL) {}
+
+  void update(StringRef Data) {
+    for (StringRef::iterator I = Data.begin(), E = Data.end(); I != E; ++I) {
+      Hash ^= (unsigned char)*I;
+      Hash *= 1099511628211ULL;
+    }
+  }
+
+  /// Adds a string along with its length so that adjacent fields cannot run
+  /// into each other.
+  void updateField(StringRef Data) {
+    uint64_t Size = Data.size();
+    update(StringRef(reinterpret_cast<const char*>(&Size), sizeof(Size)));
+    update(Data);
+  }
+
+  uint64_t getHash() const { return Hash; }
+};
+
+struct CacheEntry {
+  std::string Path;
+  sys::TimeValue ModTime;
+  uint64_t Size;
+
+  bool operator<(const CacheEntry &RHS) const {
+    return ModTime < RHS.ModTime;
+  }
+};
+
+} // end anonymous namespace
+
+FileObjectCache::FileObjectCache(StringRef CacheDir, StringRef CPU,
+                                 StringRef Features,
+                                 CodeGenOpt::Level OptLevel, uint64_t MaxSize)
+  : CacheDir(CacheDir), CPU(CPU), Features(Features), OptLevel(OptLevel),
+    MaxSize(MaxSize) {}
+
+FileObjectCache::~FileObjectCache() {
+  for (StringMap<MemoryBuffer*>::iterator I = LoadedObjects.begin(),
+       E = LoadedObjects.end(); I != E; ++I)
+    delete I->second;
+}
+
+std::string FileObjectCache::getCachePath(const Module *M) const {
+  SmallString<4096> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  Hasher H;
+  H.updateField(Bitcode);
+  H.updateField(M->getTargetTriple());
+  H.updateField(CPU);
+  H.updateField(Features);
+  H.updateField(StringRef(reinterpret_cast<const char*>(&OptLevel),
+                          sizeof(OptLevel)));
+
+  // The bitcode size is part of the name as a cheap guard against hash
+  // collisions.
+  SmallString<32> Name;
+  raw_svector_ostream(Name) << format("%016llx", (unsigned long long)
+                                      H.getHash())
+                            << '-' << Bitcode.size() << ".o";
+
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, Name.str());
+  return Path.str();
+}
+
+const MemoryBuffer *FileObjectCache::getObject(const Module *M) {
+  std::string Path = getCachePath(M);
+
+  StringMap<MemoryBuffer*>::iterator I = LoadedObjects.find(Path);
+  if (I != LoadedObjects.end())
+    return I->second;
+
+  OwningPtr<MemoryBuffer> Obj;
+  if (MemoryBuffer::getFile(Path, Obj, -1, /*RequiresNullTerminator=*/false)) {
+    // The module is about to be compiled, and codegen will change it before
+    // notifyObjectCompiled sees it.  Remember the key it was looked up by.
+    PendingPaths[M] = Path;
+    return 0;
+  }
+
+  MemoryBuffer *&Entry = LoadedObjects[Path];
+  Entry = Obj.take();
+  return Entry;
+}
+
+void FileObjectCache::notifyObjectCompiled(const Module *M,
+                                           const MemoryBuffer *Obj) {
+  std::string Path;
+  DenseMap<const Module*, std::string>::iterator PI = PendingPaths.find(M);
+  if (PI != PendingPaths.end()) {
+    Path.swap(PI->second);
+    PendingPaths.erase(PI);
+  } else {
+    Path = getCachePath(M);
+  }
+
+  // Failures here only cost a recompile next time, so they are ignored.
+  bool Existed;
+  if (sys::fs::create_directories(CacheDir, Existed))
+    return;
+
+  {
+    // If another process is writing the same object, leave it to them.
+    LockFileManager Locked(Path);
+    if (Locked != LockFileManager::LFS_Owned)
+      return;
+
+    bool Exists;
+    if (sys::fs::exists(Path, Exists) || Exists)
+      return;
+
+    int FD;
+    SmallString<128> TempPath;
+    if (sys::fs::unique_file(Path + "-%%%%%%.tmp", FD, TempPath))
+      return;
+
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Obj->getBuffer();
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath.str(), Existed);
+      return;
+    }
+
+    if (sys::fs::rename(TempPath.str(), Path)) {
+      sys::fs::remove(TempPath.str(), Existed);
+      return;
+    }
+  }
+
+  prune();
+}
+
+void FileObjectCache::prune() {
+  if (MaxSize == 0)
+    return;
+
+  std::vector<CacheEntry> Entries;
+  uint64_t TotalSize = 0;
+  error_code EC;
+  for (sys::fs::directory_iterator I(CacheDir, EC), E; I != E && !EC;
+       I.increment(EC)) {
+    // Skip lock and temporary files, along with anything we did not write.
+    if (sys::path::extension(I->path()) != ".o")
+      continue;
+    sys::fs::file_status Status;
+    if (I->status(Status) || !sys::fs::is_regular_file(Status))
+      continue;
+
+    CacheEntry Entry;
+    Entry.Path = I->path();
+    Entry.ModTime = Status.getLastModificationTime();
+    Entry.Size = Status.getSize();
+    TotalSize += Entry.Size;
+    Entries.push_back(Entry);
+  }
+
+  if (TotalSize <= MaxSize)
+    return;
+
+  std::sort(Entries.begin(), Entries.end());
+  for (std::vector<CacheEntry>::iterator I = Entries.begin(),
+       E = Entries.end(); I != E && TotalSize > MaxSize; ++I) {
+    bool Existed;
+    if (!sys::fs::remove(I->Path, Existed))
+      TotalSize -= I->Size;
+  }
+}
@@ -18,6 +18,7 @@
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
 #include "llvm/MC/MCAsmInfo.h"
 #include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -54,14 +55,16 @@ MCJIT::MCJIT(Module *m, TargetMachine *tm, RTDyldMemoryManager *MM,
              bool AllocateGVsWithCode)
   : ExecutionEngine(m), TM(tm), Ctx(0),
     MemMgr(MM ? MM : new SectionMemoryManager()), Dyld(MemMgr),
-    IsLoaded(false), M(m), ObjCache(0)  {
+    ObjCache(0)  {
 
   setDataLayout(TM->getDataLayout());
 }
 
 MCJIT::~MCJIT() {
-  if (LoadedObject)
-    NotifyFreeingObject(*LoadedObject.get());
+  for (unsigned i = 0, e = LoadedObjects.size(); i != e; ++i) {
+    NotifyFreeingObject(*LoadedObjects[i]);
+    delete LoadedObjects[i];
+  }
   delete MemMgr;
   delete TM;
 }
@@ -71,20 +74,9 @@ void MCJIT::setObjectCache(ObjectCache* NewCache) {
 }
 
 ObjectBufferStream* MCJIT::emitObject(Module *m) {
-  /// Currently, MCJIT only supports a single module and the module passed to
-  /// this function call is expected to be the contained module.  The module
-  /// is passed as a parameter here to prepare for multiple module support in
-  /// the future.
-  assert(M == m);
-
   // Get a thread lock to make sure we aren't trying to compile multiple times
   MutexGuard locked(lock);
 
-  // FIXME: Track compilation state on a per-module basis when multiple modules
-  //        are supported.
-  // Re-compilation is not supported
-  assert(!IsLoaded);
-
   PassManager PM;
 
   PM.add(new DataLayout(*TM->getDataLayout()));
@@ -120,12 +112,6 @@ void MCJIT::loadObject(Module *M) {
   // Get a thread lock to make sure we aren't trying to load multiple times
   MutexGuard locked(lock);
 
-  // FIXME: Track compilation state on a per-module basis when multiple modules
-  //        are supported.
-  // Re-compilation is not supported
-  if (IsLoaded)
-    return;
-
   OwningPtr<ObjectBuffer> ObjectToLoad;
   // Try to load the pre-compiled object from cache if possible
   if (0 != ObjCache) {
@@ -142,38 +128,75 @@ void MCJIT::loadObject(Module *M) {
 
   // Load the object into the dynamic linker.
   // handing off ownership of the buffer
-  LoadedObject.reset(Dyld.loadObject(ObjectToLoad.take()));
+  ObjectImage *LoadedObject = Dyld.loadObject(ObjectToLoad.take());
   if (!LoadedObject)
     report_fatal_error(Dyld.getErrorString());
-
-  // Resolve any relocations.
-  Dyld.resolveRelocations();
+  LoadedObjects.push_back(LoadedObject);
 
   // FIXME: Make this optional, maybe even move it to a JIT event listener
   LoadedObject->registerWithDebugger();
 
   NotifyObjectEmitted(*LoadedObject);
+}
+
+void MCJIT::generateCodeForModule(Module *M) {
+  MutexGuard locked(lock);
 
-  // FIXME: Add support for per-module compilation state
-  IsLoaded = true;
+  // Loading a module pulls in the modules defining the symbols it references,
+  // so that all of them are in the dynamic linker's symbol table before any
+  // relocation is resolved.  Modules are marked as loaded before they are
+  // compiled, which keeps mutually referencing modules from looping.
+  SmallVector<Module*, 4> Worklist;
+  Worklist.push_back(M);
+  while (!Worklist.empty()) {
+    Module *Mod = Worklist.pop_back_val();
+    if (!LoadedModules.insert(Mod))
+      continue;
+
+    loadObject(Mod);
+
+    for (Module::iterator I = Mod->begin(), E = Mod->end(); I != E; ++I)
+      if (I->isDeclaration())
+        if (Module *Def = findModuleForSymbol(I->getName()))
+          Worklist.push_back(Def);
+    for (Module::global_iterator I = Mod->global_begin(),
+           E = Mod->global_end(); I != E; ++I)
+      if (I->isDeclaration())
+        if (Module *Def = findModuleForSymbol(I->getName()))
+          Worklist.push_back(Def);
+  }
+}
+
+Module *MCJIT::findModuleForSymbol(StringRef Name) {
+  for (unsigned i = 0, e = Modules.size(); i != e; ++i) {
+    GlobalValue *GV = Modules[i]->getNamedValue(Name);
+    if (GV && !GV->isDeclaration() && !GV->hasLocalLinkage() &&
+        !GV->hasAvailableExternallyLinkage())
+      return Modules[i];
+  }
+  return 0;
+}
+
+uint64_t MCJIT::getSymbolAddress(StringRef Name) {
+  // FIXME: Should the Dyld be retaining module information? Probably not.
+  // FIXME: Should we be using the mangler for this? Probably.
+  //
+  // This is the accessor for the target address, so make sure to check the
+  // load address of the symbol, not the local address.
+  if (!Name.empty() && Name[0] == '\1')
+    return Dyld.getSymbolLoadAddress(Name.substr(1));
+  return Dyld.getSymbolLoadAddress((TM->getMCAsmInfo()->getGlobalPrefix()
+                                    + Name).str());
 }
 
-// FIXME: Add a parameter to identify which object is being finalized when
-// MCJIT supports multiple modules.
 // FIXME: Provide a way to separate code emission, relocations and page 
 // protection in the interface.
 void MCJIT::finalizeObject() {
-  // If the module hasn't been compiled, just do that.
-  if (!IsLoaded) {
-    // If the call to Dyld.resolveRelocations() is removed from loadObject()
-    // we'll need to do that here.
-    loadObject(M);
-
-    // Set page permissions.
-    MemMgr->applyPermissions();
+  MutexGuard locked(lock);
 
-    return;
-  }
+  // Generate code for every module that has not been requested yet.
+  for (unsigned i = 0, e = Modules.size(); i != e; ++i)
+    generateCodeForModule(Modules[i]);
 
   // Resolve any relocations.
   Dyld.resolveRelocations();
@@ -192,10 +215,6 @@ void *MCJIT::getPointerToFunction(Function *F) {
   // ExecutionEngine interface, though. Fix that when the old JIT finally
   // dies.
 
-  // FIXME: Add support for per-module compilation state
-  if (!IsLoaded)
-    loadObject(M);
-
   if (F->isDeclaration() || F->hasAvailableExternallyLinkage()) {
     bool AbortOnFailure = !F->hasExternalWeakLinkage();
     void *Addr = getPointerToNamedFunction(F->getName(), AbortOnFailure);
@@ -203,16 +222,15 @@ void *MCJIT::getPointerToFunction(Function *F) {
     return Addr;
   }
 
-  // FIXME: Should the Dyld be retaining module information? Probably not.
-  // FIXME: Should we be using the mangler for this? Probably.
-  //
-  // This is the accessor for the target address, so make sure to check the
-  // load address of the symbol, not the local address.
-  StringRef BaseName = F->getName();
-  if (BaseName[0] == '\1')
-    return (void*)Dyld.getSymbolLoadAddress(BaseName.substr(1));
-  return (void*)Dyld.getSymbolLoadAddress((TM->getMCAsmInfo()->getGlobalPrefix()
-                                       + BaseName).str());
+  MutexGuard locked(lock);
+
+  // Only the module defining F, and the modules it depends on, are compiled.
+  generateCodeForModule(F->getParent());
+
+  // Resolve any relocations.
+  Dyld.resolveRelocations();
+
+  return (void*)getSymbolAddress(F->getName());
 }
 
 void *MCJIT::recompileAndRelinkFunction(Function *F) {
@@ -325,9 +343,16 @@ GenericValue MCJIT::runFunction(Function *F,
 
 void *MCJIT::getPointerToNamedFunction(const std::string &Name,
                                        bool AbortOnFailure) {
-  // FIXME: Add support for per-module compilation state
-  if (!IsLoaded)
-    loadObject(M);
+  // A definition in one of our own modules takes precedence over anything
+  // found outside of the JIT.
+  {
+    MutexGuard locked(lock);
+    if (Module *Def = findModuleForSymbol(Name)) {
+      generateCodeForModule(Def);
+      Dyld.resolveRelocations();
+      return (void*)getSymbolAddress(Name);
+    }
+  }
 
   if (!isSymbolSearchingDisabled() && MemMgr) {
     void *ptr = MemMgr->getPointerToNamedFunction(Name, false);
@@ -347,6 +372,13 @@ void *MCJIT::getPointerToNamedFunction(const std::string &Name,
   return 0;
 }
 
+bool MCJIT::removeModule(Module *M) {
+  MutexGuard locked(lock);
+  // Code already generated for M stays loaded; just forget about the module.
+  LoadedModules.erase(M);
+  return ExecutionEngine::removeModule(M);
+}
+
 void MCJIT::RegisterJITEventListener(JITEventListener *L) {
   if (L == NULL)
     return;
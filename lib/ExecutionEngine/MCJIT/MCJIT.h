@@ -10,6 +10,7 @@
 #ifndef LLVM_LIB_EXECUTIONENGINE_MCJIT_H
 #define LLVM_LIB_EXECUTIONENGINE_MCJIT_H
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
@@ -20,9 +21,11 @@ namespace llvm {
 
 class ObjectImage;
 
-// FIXME: This makes all kinds of horrible assumptions for the time being,
-// like only having one module, not needing to worry about multi-threading,
-// blah blah. Purely in get-it-up-and-limping mode for now.
+// MCJIT may hold any number of modules.  Modules are added with addModule and
+// are compiled lazily: a module is only code-generated and loaded into the
+// RuntimeDyld when one of its symbols is first requested (or when
+// finalizeObject is called), together with any other added modules that
+// define symbols it references.
 
 class MCJIT : public ExecutionEngine {
   MCJIT(Module *M, TargetMachine *tm, RTDyldMemoryManager *MemMgr,
@@ -34,10 +37,11 @@ class MCJIT : public ExecutionEngine {
   RuntimeDyld Dyld;
   SmallVector<JITEventListener*, 2> EventListeners;
 
-  // FIXME: Add support for multiple modules
-  bool IsLoaded;
-  Module *M;
-  OwningPtr<ObjectImage> LoadedObject;
+  // Modules whose code has been generated and loaded into Dyld.
+  SmallPtrSet<Module*, 4> LoadedModules;
+
+  // Loaded object images, in load order.  Owned by MCJIT.
+  SmallVector<ObjectImage*, 2> LoadedObjects;
 
   // An optional ObjectCache to be notified of compiled objects and used to
   // perform lookup of pre-compiled code to avoid re-compilation.
@@ -85,6 +89,8 @@ public:
     Dyld.mapSectionAddress(LocalAddress, TargetAddress);
   }
 
+  virtual bool removeModule(Module *M);
+
   virtual void RegisterJITEventListener(JITEventListener *L);
   virtual void UnregisterJITEventListener(JITEventListener *L);
 
@@ -105,15 +111,26 @@ public:
   // @}
 
 protected:
-  /// emitObject -- Generate a JITed object in memory from the specified module
-  /// Currently, MCJIT only supports a single module and the module passed to
-  /// this function call is expected to be the contained module.  The module
-  /// is passed as a parameter here to prepare for multiple module support in 
-  /// the future.
+  /// emitObject -- Generate a JITed object in memory from the specified
+  /// module.
   ObjectBufferStream* emitObject(Module *M);
 
+  /// loadObject -- Compile M (or fetch it from the object cache) and load the
+  /// resulting object into the dynamic linker.  Relocations are not resolved.
   void loadObject(Module *M);
 
+  /// generateCodeForModule -- Load M, if it has not been loaded yet, along
+  /// with every not yet loaded module that defines a symbol M references.
+  void generateCodeForModule(Module *M);
+
+  /// findModuleForSymbol -- Return the added module that provides a
+  /// definition of the global named Name, or null if there is none.
+  Module *findModuleForSymbol(StringRef Name);
+
+  /// getSymbolAddress -- Return the target address of the symbol for the
+  /// global named Name in the loaded objects, or 0 if it is not known.
+  uint64_t getSymbolAddress(StringRef Name);
+
   void NotifyObjectEmitted(const ObjectImage& Obj);
   void NotifyFreeingObject(const ObjectImage& Obj);
 };
@@ -34,14 +34,19 @@ void RuntimeDyldImpl::resolveRelocations() {
   // First, resolve relocations associated with external symbols.
   resolveExternalSymbols();
 
-  // Just iterate over the sections we have and resolve all the relocations
-  // in them. Gross overkill, but it gets the job done.
+  // Just iterate over the sections we have and resolve the relocations in
+  // them that have not been applied at the current load addresses yet.
   for (int i = 0, e = Sections.size(); i != e; ++i) {
+    const RelocationList &Relocs = Relocations[i];
+    unsigned &NumResolved = NumResolvedRelocations[i];
+    if (NumResolved == Relocs.size())
+      continue;
     uint64_t Addr = Sections[i].LoadAddress;
     DEBUG(dbgs() << "Resolving relocations Section #" << i
             << "\t" << format("%p", (uint8_t *)Addr)
             << "\n");
-    resolveRelocationList(Relocations[i], Addr);
+    resolveRelocationList(makeArrayRef(Relocs).slice(NumResolved), Addr);
+    NumResolved = Relocs.size();
   }
 }
 
@@ -403,9 +408,13 @@ void RuntimeDyldImpl::reassignSectionAddress(unsigned SectionID,
   // of the target is the same as that of the host. Just use a generic
   // "big enough" type.
   Sections[SectionID].LoadAddress = Addr;
+
+  // Every relocation has to be applied again against the new layout.
+  NumResolvedRelocations.clear();
+  NumResolvedExternalRelocations.clear();
 }
 
-void RuntimeDyldImpl::resolveRelocationList(const RelocationList &Relocs,
+void RuntimeDyldImpl::resolveRelocationList(ArrayRef<RelocationEntry> Relocs,
                                             uint64_t Value) {
   for (unsigned i = 0, e = Relocs.size(); i != e; ++i) {
     const RelocationEntry &RE = Relocs[i];
@@ -419,15 +428,21 @@ void RuntimeDyldImpl::resolveRelocationList(const RelocationList &Relocs,
 void RuntimeDyldImpl::resolveExternalSymbols() {
   StringMap<RelocationList>::iterator i = ExternalSymbolRelocations.begin(),
                                       e = ExternalSymbolRelocations.end();
-  for (; i != e; i++) {
-    StringRef Name = i->first();
-    RelocationList &Relocs = i->second;
+  while (i != e) {
+    StringMap<RelocationList>::iterator Cur = i;
+    ++i;
+    StringRef Name = Cur->first();
+    RelocationList &Relocs = Cur->second;
+    unsigned &NumResolved = NumResolvedExternalRelocations[Name];
+    if (NumResolved == Relocs.size())
+      continue;
+    ArrayRef<RelocationEntry> Pending = makeArrayRef(Relocs).slice(NumResolved);
     SymbolTableMap::const_iterator Loc = GlobalSymbolTable.find(Name);
     if (Loc == GlobalSymbolTable.end()) {
       if (Name.size() == 0) {
         // This is an absolute symbol, use an address of zero.
         DEBUG(dbgs() << "Resolving absolute relocations." << "\n");
-        resolveRelocationList(Relocs, 0);
+        resolveRelocationList(Pending, 0);
       } else {
         // This is an external symbol, try to get its address from
         // MemoryManager.
@@ -436,10 +451,25 @@ void RuntimeDyldImpl::resolveExternalSymbols() {
         DEBUG(dbgs() << "Resolving relocations Name: " << Name
                 << "\t" << format("%p", Addr)
                 << "\n");
-        resolveRelocationList(Relocs, (uintptr_t)Addr);
+        resolveRelocationList(Pending, (uintptr_t)Addr);
       }
+      NumResolved = Relocs.size();
     } else {
-      report_fatal_error("Expected external symbol");
+      // The symbol was defined by an object loaded after the one referencing
+      // it.  Turn the pending relocations into section relocations, just as
+      // addRelocationForSymbol would have done had the symbol been known.
+      DEBUG(dbgs() << "Binding relocations Name: " << Name
+                   << " to Section #" << Loc->second.first << "\n");
+      for (unsigned j = 0, je = Pending.size(); j != je; ++j) {
+        RelocationEntry RECopy = Pending[j];
+        RECopy.Addend += Loc->second.second;
+        Relocations[Loc->second.first].push_back(RECopy);
+      }
+      Relocs.erase(Relocs.begin() + NumResolved, Relocs.end());
+      if (Relocs.empty()) {
+        NumResolvedExternalRelocations.erase(Name);
+        ExternalSymbolRelocations.erase(Cur);
+      }
     }
   }
 }
@@ -14,6 +14,7 @@
 #ifndef LLVM_RUNTIME_DYLD_IMPL_H
 #define LLVM_RUNTIME_DYLD_IMPL_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
@@ -161,6 +162,14 @@ protected:
   // modules.  This map is indexed by symbol name.
   StringMap<RelocationList> ExternalSymbolRelocations;
 
+  // The number of entries at the front of each of the lists above that have
+  // already been applied at the current section load addresses.  Only new
+  // relocations are applied by resolveRelocations, so that loading another
+  // object does not rewrite code that may already have been protected.
+  // Reassigning a section address resets the counts.
+  DenseMap<unsigned, unsigned> NumResolvedRelocations;
+  StringMap<unsigned> NumResolvedExternalRelocations;
+
   typedef std::map<RelocationValueRef, uintptr_t> StubMap;
 
   Triple::ArchType Arch;
@@ -270,7 +279,7 @@ protected:
   uint8_t* createStubFunction(uint8_t *Addr);
 
   /// \brief Resolves relocations from Relocs list with address from Value.
-  void resolveRelocationList(const RelocationList &Relocs, uint64_t Value);
+  void resolveRelocationList(ArrayRef<RelocationEntry> Relocs, uint64_t Value);
 
   /// \brief A object file specific relocation resolver
   /// \param RE The relocation to be resolved
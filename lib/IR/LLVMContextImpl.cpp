@@ -42,17 +42,7 @@ LLVMContextImpl::LLVMContextImpl(LLVMContext &C)
 
 namespace {
 struct DropReferences {
-  // Takes the value_type of a ConstantUniqueMap's internal map, whose 'second'
-  // is a Constant*.
-  template<typename PairT>
-  void operator()(const PairT &P) {
-    P.second->dropAllReferences();
-  }
-};
-
-// Temporary - drops pair.first instead of second.
-struct DropFirst {
-  // Takes the value_type of a ConstantUniqueMap's internal map, whose 'second'
+  // Takes the value_type of a ConstantUniqueMap's internal map, whose 'first'
   // is a Constant*.
   template<typename PairT>
   void operator()(const PairT &P) {
@@ -74,11 +64,11 @@ LLVMContextImpl::~LLVMContextImpl() {
   std::for_each(ExprConstants.map_begin(), ExprConstants.map_end(),
                 DropReferences());
   std::for_each(ArrayConstants.map_begin(), ArrayConstants.map_end(),
-                DropFirst());
+                DropReferences());
   std::for_each(StructConstants.map_begin(), StructConstants.map_end(),
-                DropFirst());
+                DropReferences());
   std::for_each(VectorConstants.map_begin(), VectorConstants.map_end(),
-                DropFirst());
+                DropReferences());
   ExprConstants.freeConstants();
   ArrayConstants.freeConstants();
   StructConstants.freeConstants();
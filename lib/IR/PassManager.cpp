@@ -1159,6 +1159,9 @@ void PMDataManager::dumpPassInfo(Pass *P, enum PassDebuggingString S1,
   case FREEING_MSG:
     dbgs() << " Freeing Pass '" << P->getPassName();
     break;
+  case REUSING_MSG:
+    dbgs() << " Reusing Pass '" << P->getPassName();
+    break;
   default:
     break;
   }
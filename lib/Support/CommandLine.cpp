@@ -106,6 +106,17 @@ void Option::addArgument() {
   MarkOptionsChanged();
 }
 
+void Option::reset() {
+  NumOccurrences = 0;
+  Position = 0;
+  setDefault();
+}
+
+void cl::ResetAllOptionOccurrences() {
+  for (Option *O = RegisteredOptionList; O; O = O->getNextRegisteredOption())
+    O->reset();
+}
+
 
 //===----------------------------------------------------------------------===//
 // Basic, shared command line option processing machinery.
@@ -430,7 +441,7 @@ static bool EatsUnboundedNumberOfValues(const Option *O) {
 /// them later.
 ///
 static void ParseCStringVector(std::vector<char *> &OutputVector,
-                               const char *Input) {
+                               StringRef Input) {
   // Characters which will be treated as token separators:
   StringRef Delims = " \v\f\t\r\n";
 
@@ -474,14 +485,25 @@ void cl::ParseEnvironmentOptions(const char *progName, const char *envVar,
   if (!envValue)
     return;
 
+  // Parse the value of the environment variable into a "command line"
+  // and hand it off to ParseCommandLineOptions().
+  ParseCommandLineString(progName, envValue, Overview);
+}
+
+/// ParseCommandLineString - An alternative entry point to the CommandLine
+/// library, which splits ARGS at whitespace and processes the words as the
+/// command-line arguments of PROGNAME.
+///
+void cl::ParseCommandLineString(const char *progName, StringRef Args,
+                                const char *Overview) {
+  assert(progName && "Program name not specified");
+
   // Get program's "name", which we wouldn't know without the caller
   // telling us.
   std::vector<char*> newArgv;
   newArgv.push_back(strdup(progName));
 
-  // Parse the value of the environment variable into a "command line"
-  // and hand it off to ParseCommandLineOptions().
-  ParseCStringVector(newArgv, envValue);
+  ParseCStringVector(newArgv, Args);
   int newArgc = static_cast<int>(newArgv.size());
   ParseCommandLineOptions(newArgc, &newArgv[0], Overview);
 
@@ -278,3 +278,16 @@ int llvm::DiffFilesWithTolerance(const sys::PathWithStatus &FileA,
 
   return CompareFailed;
 }
+
+bool llvm::ReadLine(FILE *Input, std::string &Line) {
+  char Buffer[1024];
+  Line.clear();
+  while (fgets(Buffer, sizeof(Buffer), Input)) {
+    Line += Buffer;
+    if (!Line.empty() && Line[Line.size() - 1] == '\n') {
+      Line.resize(Line.size() - 1);
+      return true;
+    }
+  }
+  return !Line.empty();
+}
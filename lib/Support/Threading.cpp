@@ -16,6 +16,7 @@
 #include "llvm/Support/Atomic.h"
 #include "llvm/Support/Mutex.h"
 #include <cassert>
+#include <vector>
 
 using namespace llvm;
 
@@ -102,6 +103,38 @@ void llvm::llvm_execute_on_thread(void (*Fn)(void*), void *UserData,
  error:
   ::pthread_attr_destroy(&Attr);
 }
+
+void llvm::llvm_execute_on_threads(void (*Fn)(void*), void **UserData,
+                                   unsigned NumThreads,
+                                   unsigned RequestedStackSize) {
+  std::vector<ThreadInfo> Infos(NumThreads);
+  std::vector<pthread_t> Threads(NumThreads);
+  std::vector<bool> Started(NumThreads, false);
+
+  pthread_attr_t Attr;
+  bool HaveAttr = ::pthread_attr_init(&Attr) == 0;
+  if (HaveAttr && RequestedStackSize != 0)
+    ::pthread_attr_setstacksize(&Attr, RequestedStackSize);
+
+  for (unsigned i = 0; i != NumThreads; ++i) {
+    Infos[i].UserFn = Fn;
+    Infos[i].UserData = UserData[i];
+    Started[i] = ::pthread_create(&Threads[i], HaveAttr ? &Attr : 0,
+                                  ExecuteOnThread_Dispatch, &Infos[i]) == 0;
+  }
+
+  // Run whatever could not be given a thread here.
+  for (unsigned i = 0; i != NumThreads; ++i)
+    if (!Started[i])
+      Fn(UserData[i]);
+
+  for (unsigned i = 0; i != NumThreads; ++i)
+    if (Started[i])
+      ::pthread_join(Threads[i], 0);
+
+  if (HaveAttr)
+    ::pthread_attr_destroy(&Attr);
+}
 #elif LLVM_ENABLE_THREADS!=0 && defined(LLVM_ON_WIN32)
 #include "Windows/Windows.h"
 #include <process.h>
@@ -136,6 +169,31 @@ void llvm::llvm_execute_on_thread(void (*Fn)(void*), void *UserData,
     ::CloseHandle(hThread);
   }
 }
+
+void llvm::llvm_execute_on_threads(void (*Fn)(void*), void **UserData,
+                                   unsigned NumThreads,
+                                   unsigned RequestedStackSize) {
+  std::vector<ThreadInfo> Infos(NumThreads);
+  std::vector<HANDLE> Threads(NumThreads);
+
+  for (unsigned i = 0; i != NumThreads; ++i) {
+    Infos[i].func = Fn;
+    Infos[i].param = UserData[i];
+    Threads[i] = (HANDLE)::_beginthreadex(NULL, RequestedStackSize,
+                                          ThreadCallback, &Infos[i], 0, NULL);
+  }
+
+  // Run whatever could not be given a thread here.
+  for (unsigned i = 0; i != NumThreads; ++i)
+    if (!Threads[i])
+      Fn(UserData[i]);
+
+  for (unsigned i = 0; i != NumThreads; ++i)
+    if (Threads[i]) {
+      (void)::WaitForSingleObject(Threads[i], INFINITE);
+      ::CloseHandle(Threads[i]);
+    }
+}
 #else
 // Support for non-Win32, non-pthread implementation.
 void llvm::llvm_execute_on_thread(void (*Fn)(void*), void *UserData,
@@ -144,4 +202,12 @@ void llvm::llvm_execute_on_thread(void (*Fn)(void*), void *UserData,
   Fn(UserData);
 }
 
+void llvm::llvm_execute_on_threads(void (*Fn)(void*), void **UserData,
+                                   unsigned NumThreads,
+                                   unsigned RequestedStackSize) {
+  (void) RequestedStackSize;
+  for (unsigned i = 0; i != NumThreads; ++i)
+    Fn(UserData[i]);
+}
+
 #endif
@@ -41,6 +41,8 @@ STATISTIC(NumMergedAllocas, "Number of allocas merged together");
 // to inline a function A into B, we analyze the callers of B in order to see
 // if those would be more profitable and blocked inline steps.
 STATISTIC(NumCallerCallersAnalyzed, "Number of caller-callers analyzed");
+STATISTIC(NumCallerCallersReused,
+          "Number of caller-caller costs reused from an earlier query");
 
 static cl::opt<int>
 InlineLimit("inline-threshold", cl::Hidden, cl::init(225), cl::ZeroOrMore,
@@ -319,21 +321,36 @@ bool Inliner::shouldInline(CallSite CS) {
         continue;
       }
 
-      InlineCost IC2 = getInlineCost(CS2);
-      ++NumCallerCallersAnalyzed;
-      if (!IC2) {
+      // Every call site in Caller that is a candidate asks about the same
+      // callers of Caller, and nothing changes while candidates are being
+      // rejected, so each of these costs is computed once per IR change.
+      std::pair<DenseMap<Instruction*, SecondaryCost>::iterator, bool> Entry =
+        SecondaryCosts.insert(std::make_pair(CS2.getInstruction(),
+                                             SecondaryCost()));
+      SecondaryCost &SC = Entry.first->second;
+      if (Entry.second) {
+        InlineCost IC2 = getInlineCost(CS2);
+        ++NumCallerCallersAnalyzed;
+        SC.Inlinable = IC2;
+        SC.Always = IC2.isAlways();
+        SC.Cost = IC2.isVariable() ? IC2.getCost() : 0;
+        SC.CostDelta = IC2.isVariable() ? IC2.getCostDelta() : 0;
+      } else {
+        ++NumCallerCallersReused;
+      }
+      if (!SC.Inlinable) {
         callerWillBeRemoved = false;
         continue;
       }
-      if (IC2.isAlways())
+      if (SC.Always)
         continue;
 
       // See if inlining or original callsite would erase the cost delta of
       // this callsite. We subtract off the penalty for the call instruction,
       // which we would be deleting.
-      if (IC2.getCostDelta() <= CandidateCost) {
+      if (SC.CostDelta <= CandidateCost) {
         inliningPreventsSomeOuterInline = true;
-        TotalSecondaryCost += IC2.getCost();
+        TotalSecondaryCost += SC.Cost;
       }
     }
     // If all outer calls to Caller would get inlined, the cost for the last
@@ -422,6 +439,9 @@ bool Inliner::runOnSCC(CallGraphSCC &SCC) {
   // If there are no calls in this function, exit early.
   if (CallSites.empty())
     return false;
+
+  // Other passes may have changed the IR since the last SCC was visited.
+  SecondaryCosts.clear();
   
   // Now that we have all of the call sites, move the ones to functions in the
   // current SCC to the end of the list.
@@ -536,11 +556,16 @@ bool Inliner::runOnSCC(CallGraphSCC &SCC) {
       }
       --CSi;
 
+      // A call was inlined or deleted, and perhaps a function with it, so the
+      // cached secondary costs may be stale or keyed by freed instructions.
+      SecondaryCosts.clear();
+
       Changed = true;
       LocalChange = true;
     }
   } while (LocalChange);
 
+  SecondaryCosts.clear();
   return Changed;
 }
 
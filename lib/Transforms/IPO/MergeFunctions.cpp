@@ -9,13 +9,15 @@
 //
 // This pass looks for equivalent functions that are mergable and folds them.
 //
-// A hash is computed from the function, based on its type and number of
-// basic blocks.
+// A hash is computed from the function, based on its type and a walk over its
+// CFG that covers the opcodes, types and constant operands of each instruction.
+// Functions that compare equal always get the same hash.
 //
-// Once all hashes are computed, we perform an expensive equality comparison
-// on each function pair. This takes n^2/2 comparisons per bucket, so it's
-// important that the hash function be high quality. The equality comparison
-// iterates through each instruction in each basic block.
+// Functions are then inserted into a hash set, and an expensive equality
+// comparison is performed against each function with the same hash. This takes
+// n^2/2 comparisons per bucket, so it's important that the hash function be
+// high quality. The equality comparison iterates through each instruction in
+// each basic block.
 //
 // When a match is found the functions are folded. If both functions are
 // overridable, we move the functionality into a new internal function and
@@ -32,7 +34,7 @@
 // and call, this is irrelevant, and we'd like to fold such functions.
 //
 // * switch from n^2 pair-wise comparisons to an n-way comparison for each
-// bucket.
+// bucket, or a total order on functions so that they can be sorted.
 //
 // * be smarter about bitcasts.
 //
@@ -47,7 +49,9 @@
 #include "llvm/Transforms/IPO.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/FoldingSet.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Constants.h"
@@ -81,20 +85,82 @@ static Type::TypeID getTypeIDForHash(Type *Ty) {
   return Ty->getTypeID();
 }
 
+/// Adds the parts of an operand that FunctionComparator requires to match.
+/// Global values are left out: a function may be compared equal to another
+/// when both refer to themselves, and their addresses would make the hash
+/// differ from run to run anyway.
+static void profileOperand(FoldingSetNodeID &ID, const Value *V) {
+  ID.AddInteger(V->getValueID());
+  ID.AddInteger(getTypeIDForHash(V->getType()));
+  if (const ConstantInt *CI = dyn_cast<ConstantInt>(V))
+    ID.AddInteger(size_t(hash_value(CI->getValue())));
+  else if (const ConstantFP *CFP = dyn_cast<ConstantFP>(V))
+    ID.AddInteger(size_t(hash_value(CFP->getValueAPF())));
+}
+
+/// Adds the parts of an instruction that FunctionComparator requires to match.
+static void profileInstruction(FoldingSetNodeID &ID, const Instruction *I) {
+  ID.AddInteger(I->getOpcode());
+
+  // GEPs are compared by the offset they compute, which may be spelled with
+  // different indices.
+  if (isa<GetElementPtrInst>(I))
+    return;
+
+  ID.AddInteger(getTypeIDForHash(I->getType()));
+  ID.AddInteger(I->getRawSubclassOptionalData());
+  ID.AddInteger(I->getNumOperands());
+  for (unsigned i = 0, e = I->getNumOperands(); i != e; ++i)
+    profileOperand(ID, I->getOperand(i));
+
+  if (const LoadInst *LI = dyn_cast<LoadInst>(I)) {
+    ID.AddBoolean(LI->isVolatile());
+    ID.AddInteger(LI->getAlignment());
+    ID.AddInteger(LI->getOrdering());
+  } else if (const StoreInst *SI = dyn_cast<StoreInst>(I)) {
+    ID.AddBoolean(SI->isVolatile());
+    ID.AddInteger(SI->getAlignment());
+    ID.AddInteger(SI->getOrdering());
+  } else if (const CmpInst *CI = dyn_cast<CmpInst>(I)) {
+    ID.AddInteger(CI->getPredicate());
+  } else if (const CallInst *CI = dyn_cast<CallInst>(I)) {
+    ID.AddInteger(CI->getCallingConv());
+  } else if (const InvokeInst *II = dyn_cast<InvokeInst>(I)) {
+    ID.AddInteger(II->getCallingConv());
+  }
+}
+
 /// Creates a hash-code for the function which is the same for any two
-/// functions that will compare equal, without looking at the instructions
-/// inside the function.
+/// functions that will compare equal. The blocks are visited in the same order
+/// as FunctionComparator::compare visits them, so that unreachable blocks and
+/// the layout of the block list do not affect the hash.
 static unsigned profileFunction(const Function *F) {
   FunctionType *FTy = F->getFunctionType();
 
   FoldingSetNodeID ID;
-  ID.AddInteger(F->size());
   ID.AddInteger(F->getCallingConv());
   ID.AddBoolean(F->hasGC());
   ID.AddBoolean(FTy->isVarArg());
   ID.AddInteger(getTypeIDForHash(FTy->getReturnType()));
   for (unsigned i = 0, e = FTy->getNumParams(); i != e; ++i)
     ID.AddInteger(getTypeIDForHash(FTy->getParamType(i)));
+
+  SmallVector<const BasicBlock *, 8> BBs;
+  SmallPtrSet<const BasicBlock *, 16> VisitedBBs;
+  BBs.push_back(&F->getEntryBlock());
+  VisitedBBs.insert(BBs[0]);
+  while (!BBs.empty()) {
+    const BasicBlock *BB = BBs.pop_back_val();
+    ID.AddInteger(BB->size());
+    for (BasicBlock::const_iterator I = BB->begin(), E = BB->end(); I != E;
+         ++I)
+      profileInstruction(ID, I);
+
+    const TerminatorInst *TI = BB->getTerminator();
+    for (unsigned i = 0, e = TI->getNumSuccessors(); i != e; ++i)
+      if (VisitedBBs.insert(TI->getSuccessor(i)))
+        BBs.push_back(TI->getSuccessor(i));
+  }
   return ID.ComputeHash();
 }
 
@@ -667,8 +733,11 @@ bool MergeFunctions::runOnModule(Module &M) {
 
 bool DenseMapInfo<ComparableFunction>::isEqual(const ComparableFunction &LHS,
                                                const ComparableFunction &RHS) {
-  if (LHS.getFunc() == RHS.getFunc() &&
-      LHS.getHash() == RHS.getHash())
+  // The set probes entries with other hashes too. Functions that compare
+  // equal always have the same hash, so skip the comparison for those.
+  if (LHS.getHash() != RHS.getHash())
+    return false;
+  if (LHS.getFunc() == RHS.getFunc())
     return true;
   if (!LHS.getFunc() || !RHS.getFunc())
     return false;
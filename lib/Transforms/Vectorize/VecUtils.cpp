@@ -46,7 +46,7 @@ namespace llvm {
 
 BoUpSLP::BoUpSLP(BasicBlock *Bb, ScalarEvolution *S, DataLayout *Dl,
                  TargetTransformInfo *Tti, AliasAnalysis *Aa, Loop *Lp) :
-  BB(Bb), SE(S), DL(Dl), TTI(Tti), AA(Aa), L(Lp)  {
+  BB(Bb), SE(S), DL(Dl), TTI(Tti), AA(Aa), AACache(Aa), L(Lp)  {
   numberInstructions();
 }
 
@@ -217,7 +217,7 @@ Value *BoUpSLP::isUnsafeToSink(Instruction *Src, Instruction *Dst) {
     AliasAnalysis::Location A = getLocation(&*I);
     AliasAnalysis::Location B = getLocation(Src);
 
-    if (!A.Ptr || !B.Ptr || AA->alias(A, B))
+    if (!A.Ptr || !B.Ptr || AACache.alias(A, B))
       return I;
   }
   return 0;
@@ -592,6 +592,8 @@ Value *BoUpSLP::vectorizeTree(ArrayRef<Value *> VL, int VF) {
   // before we can do any analysis.
   numberInstructions();
   MustScalarize.clear();
+  // The scalar stores were deleted, so their addresses may be reused.
+  AACache.clear();
   return V;
 }
 
@@ -156,6 +156,9 @@ private:
   DataLayout *DL;
   TargetTransformInfo *TTI;
   AliasAnalysis *AA;
+  /// The same pairs of memory accesses are checked by isUnsafeToSink for each
+  /// tree that is costed, so the answers are kept until the IR changes.
+  AliasQueryCache AACache;
   Loop *L;
 };
 
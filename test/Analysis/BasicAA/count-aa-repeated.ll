@@ -0,0 +1,17 @@
+; RUN: opt < %s -basicaa -count-aa -count-aa-print-all-queries=false -aa-eval -evaluate-tbaa -disable-output 2>&1 | FileCheck %s
+
+; The load/store pairs evaluated by -evaluate-tbaa repeat the pointer pairs,
+; and the counter reports how many queries an AliasQueryCache would answer.
+
+; CHECK: ===== Alias Analysis Counter Report =====
+; CHECK: 10 Total Alias Queries Performed
+; CHECK: 6 repeated alias queries (60%)
+
+define void @f(i32* noalias %p, i32* noalias %q) {
+  store i32 0, i32* %p
+  store i32 1, i32* %q
+  %a = load i32* %p
+  store i32 2, i32* %q
+  %b = load i32* %p
+  ret void
+}
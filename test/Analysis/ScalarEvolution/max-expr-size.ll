@@ -0,0 +1,26 @@
+; RUN: opt < %s -analyze -scalar-evolution -scalar-evolution-max-expr-size=5 | FileCheck %s
+; RUN: opt < %s -analyze -scalar-evolution -scev-stats 2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+
+; Expressions with more nodes than the limit are replaced by unknowns.
+
+define i32 @f(i32 %a, i32 %b, i32 %c, i32 %d) {
+entry:
+; CHECK: %x = add i32 %a, %b
+; CHECK-NEXT: -->  (%a + %b)
+  %x = add i32 %a, %b
+; CHECK: %y = mul i32 %x, %c
+; CHECK-NEXT: -->  ((%a + %b) * %c)
+  %y = mul i32 %x, %c
+; CHECK: %z = add i32 %y, %d
+; CHECK-NEXT: -->  %z
+  %z = add i32 %y, %d
+; CHECK: %w = add i32 %z, 1
+; CHECK-NEXT: -->  %w
+  %w = add i32 %z, 1
+  ret i32 %w
+}
+
+; STATS: ScalarEvolution statistics for 'f':
+; STATS: 1 mul nodes
+; STATS: bytes allocated for nodes
+; STATS: values at scopes
@@ -0,0 +1,43 @@
+; Check that the function index is written and that lazily materialized
+; bodies are found through it.
+; RUN: llvm-as -enable-bc-function-index < %s | llvm-bcanalyzer -dump \
+; RUN:   | FileCheck %s --check-prefix=BC
+; RUN: llvm-as -enable-bc-function-index < %s | llvm-dis | FileCheck %s
+; RUN: llvm-as -enable-bc-function-index < %s | llvm-extract -func=b \
+; RUN:   | llvm-dis | FileCheck %s --check-prefix=EXTRACT
+
+; BC: <FUNCTION_INDEX_BLOCK
+; BC-NEXT: <FUNC_INDEX_CODE_OFFSETS
+; BC-NEXT: </FUNCTION_INDEX_BLOCK>
+; BC-NEXT: <FUNCTION_BLOCK
+
+@g = global i32 5
+
+; CHECK: define i32 @a(i32 %x)
+; CHECK-NEXT: add i32 %x, 1
+define i32 @a(i32 %x) {
+  %y = add i32 %x, 1
+  ret i32 %y
+}
+
+declare i32 @ext(i32)
+
+; CHECK: define i32 @b(i32 %x)
+; CHECK-NEXT: call i32 @ext(i32 %x)
+; EXTRACT-NOT: define i32 @a
+; EXTRACT: define i32 @b(i32 %x)
+; EXTRACT-NEXT: call i32 @ext(i32 %x)
+; EXTRACT-NEXT: mul i32 %y, 3
+define i32 @b(i32 %x) {
+  %y = call i32 @ext(i32 %x)
+  %z = mul i32 %y, 3
+  ret i32 %z
+}
+
+; CHECK: define i32 @main()
+; CHECK-NEXT: load i32* @g
+define i32 @main() {
+  %v = load i32* @g
+  %r = call i32 @b(i32 %v)
+  ret i32 %r
+}
@@ -0,0 +1,28 @@
+; RUN: llc < %s -mtriple=x86_64-linux -O2 -debug-pass=Executions -o /dev/null 2>&1 | FileCheck %s
+
+; The dominator tree and loop info only depend on the CFG. When a pass that
+; does not preserve them leaves the CFG alone, the next pass that needs them
+; should take over the result already stored in the MachineFunction.
+
+; CHECK: Reusing Pass 'MachineDominator Tree Construction'
+; CHECK: Reusing Pass 'Machine Natural Loop Construction'
+
+define i32 @loop(i32* %p, i32 %n) nounwind {
+entry:
+  %cmp = icmp sgt i32 %n, 0
+  br i1 %cmp, label %body, label %exit
+
+body:
+  %i = phi i32 [ 0, %entry ], [ %inc, %body ]
+  %s = phi i32 [ 0, %entry ], [ %add, %body ]
+  %gep = getelementptr i32* %p, i32 %i
+  %v = load i32* %gep
+  %add = add i32 %s, %v
+  %inc = add i32 %i, 1
+  %done = icmp eq i32 %inc, %n
+  br i1 %done, label %exit, label %body
+
+exit:
+  %r = phi i32 [ 0, %entry ], [ %add, %body ]
+  ret i32 %r
+}
@@ -0,0 +1,50 @@
+; RUN: llc < %s -disable-cgp -dag-block-node-limit=16 | FileCheck %s
+
+; CodeGenPrepare is disabled so the llvm.dbg.value stays after the cut that
+; ends the DAG computing %t.  %t is not used past the cut, yet the variable
+; must still be described.
+
+; CHECK: h:
+; CHECK: #DEBUG_VALUE: t <-
+; CHECK: callq g
+
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @g(i32)
+declare void @llvm.dbg.value(metadata, i64, metadata) nounwind readnone
+
+define void @h(i32* %p, i32 %a) nounwind {
+entry:
+  %t = mul i32 %a, 7, !dbg !9
+  %p1 = getelementptr i32* %p, i64 1
+  %p2 = getelementptr i32* %p, i64 2
+  %v0 = load i32* %p
+  %v1 = load i32* %p1
+  %v2 = load i32* %p2
+  %s0 = add i32 %v0, %t
+  %s1 = mul i32 %s0, %v1
+  %s2 = xor i32 %s1, %v2
+  call void @g(i32 %s2)
+  %s3 = shl i32 %s2, 3
+  store i32 %s3, i32* %p2
+  call void @g(i32 %s3)
+  tail call void @llvm.dbg.value(metadata !{i32 %t}, i64 0, metadata !6), !dbg !9
+  call void @g(i32 %s1)
+  ret void, !dbg !10
+}
+
+!llvm.dbg.cu = !{!2}
+
+!0 = metadata !{i32 786478, metadata !1, metadata !"h", metadata !"h", metadata !"h", metadata !1, i32 12, metadata !3, i1 false, i1 true, i32 0, i32 0, null, i1 false, i1 true, void (i32*, i32)* @h, null, null, metadata !12, i32 0} ; [ DW_TAG_subprogram ]
+!1 = metadata !{i32 786473, metadata !13} ; [ DW_TAG_file_type ]
+!2 = metadata !{i32 786449, i32 12, metadata !1, metadata !"clang", i1 true, metadata !"", i32 0, null, null, metadata !11, null,  null, metadata !""} ; [ DW_TAG_compile_unit ]
+!3 = metadata !{i32 786453, metadata !1, metadata !"", metadata !1, i32 0, i64 0, i64 0, i64 0, i32 0, null, metadata !4, i32 0, null}
+!4 = metadata !{null}
+!5 = metadata !{i32 786468, metadata !1, metadata !"int", metadata !1, i32 0, i64 32, i64 32, i64 0, i32 0, i32 5}
+!6 = metadata !{i32 786688, metadata !7, metadata !"t", metadata !1, i32 15, metadata !5, i32 0, null}
+!7 = metadata !{i32 786443, metadata !1, metadata !0, i32 12, i32 52, i32 0} ; [ DW_TAG_lexical_block ]
+!9 = metadata !{i32 15, i32 12, metadata !7, null}
+!10 = metadata !{i32 23, i32 3, metadata !7, null}
+!11 = metadata !{metadata !0}
+!12 = metadata !{metadata !6}
+!13 = metadata !{metadata !"t.c", metadata !"/tmp"}
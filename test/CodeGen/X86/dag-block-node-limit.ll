@@ -0,0 +1,63 @@
+; RUN: llc < %s -march=x86-64 -dag-block-node-limit=16 -verify-machineinstrs \
+; RUN:   -stats 2>&1 | FileCheck %s
+; RUN: llc < %s -march=x86-64 -stats 2>&1 | FileCheck %s -check-prefix=NOSPLIT
+; REQUIRES: asserts
+
+; With a node limit, the long entry block is selected as several DAGs.  The
+; arguments, the loaded values and the partial sums have to be carried from
+; one DAG to the next in registers, and the compare feeding the branch must
+; stay with the terminator.
+
+; %s0 and %v2 are computed before the call and used after it.  They must be
+; carried in registers rather than recomputed, and the compare must still be
+; selected together with the branch.
+; CHECK: f:
+; CHECK: movl (%rdi), [[S0:%[a-z0-9]+]]
+; CHECK-NEXT: addl %esi, [[S0]]
+; CHECK: leaq 8(%rdi), [[P2:%[a-z0-9]+]]
+; CHECK: movl ([[P2]]), [[V2:%[a-z0-9]+]]
+; CHECK: callq g
+; CHECK: addl [[S0]], [[S6:%[a-z0-9]+]]
+; CHECK: orl [[V2]], [[S6]]
+; CHECK: cmpl {{.*}}, [[S6]]
+; CHECK-NEXT: jge
+; CHECK: ret
+; CHECK: isel - Number of blocks split into several DAGs to bound their size
+; CHECK: isel - Number of extra DAGs created by splitting large blocks
+
+; NOSPLIT-NOT: Number of blocks split into several DAGs
+
+declare void @g(i32)
+
+define i32 @f(i32* %p, i32 %a, i32 %b) nounwind {
+entry:
+  %p1 = getelementptr i32* %p, i64 1
+  %p2 = getelementptr i32* %p, i64 2
+  %p3 = getelementptr i32* %p, i64 3
+  %p4 = getelementptr i32* %p, i64 4
+  %v0 = load i32* %p
+  %v1 = load i32* %p1
+  %v2 = load i32* %p2
+  %v3 = load i32* %p3
+  %v4 = load i32* %p4
+  %s0 = add i32 %v0, %a
+  %s1 = mul i32 %s0, %v1
+  %s2 = xor i32 %s1, %v2
+  %s3 = sub i32 %s2, %v3
+  %s4 = add i32 %s3, %v4
+  call void @g(i32 %s4)
+  %s5 = mul i32 %s4, %b
+  %s6 = add i32 %s5, %s0
+  store i32 %s6, i32* %p4
+  %s7 = shl i32 %s6, 3
+  %s8 = or i32 %s7, %v2
+  store i32 %s8, i32* %p3
+  %c = icmp slt i32 %s8, %a
+  br i1 %c, label %then, label %else
+
+then:
+  ret i32 %s8
+
+else:
+  ret i32 %s1
+}
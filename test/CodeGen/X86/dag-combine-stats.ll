@@ -0,0 +1,14 @@
+; RUN: llc < %s -march=x86-64 -dag-combine-stats -o /dev/null 2>&1 | FileCheck %s
+
+; CHECK: ... DAG Combine Statistics ...
+; CHECK: Attempts Hits Opcode
+; CHECK-DAG: {{[0-9]+}} {{[0-9]+}} add
+; CHECK-DAG: {{[0-9]+}} {{[0-9]+}} shl
+
+define i32 @f(i32 %a, i32 %b) nounwind {
+entry:
+  %s = shl i32 %a, 2
+  %x = add i32 %s, %b
+  %y = add i32 %x, 0
+  ret i32 %y
+}
@@ -0,0 +1,30 @@
+; RUN: llc < %s -mcpu=generic -mtriple=x86_64-apple-macosx -stats -o /dev/null 2>&1 | FileCheck %s
+; RUN: llc < %s -mcpu=generic -mtriple=x86_64-apple-macosx -interference-cache-budget=0 -stats -o /dev/null 2>&1 | FileCheck %s
+; REQUIRES: asserts
+
+; %x and %y are split around the call, which queries the interference cache.
+
+; CHECK: {{[0-9]+}} regalloc {{.*}} Number of block interferences recomputed
+; CHECK: {{[0-9]+}} regalloc {{.*}} Number of interference cache entry hits
+; CHECK: {{[0-9]+}} regalloc {{.*}} Number of interference cache entry misses
+
+define i32 @f(float %x, float %y) nounwind uwtable ssp {
+entry:
+  %add = fadd float %x, %y
+  %conv = fpext float %add to double
+  %call = tail call i32 @finit(double %conv) nounwind
+  %tobool = icmp eq i32 %call, 0
+  br i1 %tobool, label %return, label %if.end
+
+if.end:
+  tail call void @foo(float %x, float %y) nounwind
+  br label %return
+
+return:
+  %retval.0 = phi i32 [ 0, %if.end ], [ 5, %entry ]
+  ret i32 %retval.0
+}
+
+declare i32 @finit(double)
+
+declare void @foo(float, float)
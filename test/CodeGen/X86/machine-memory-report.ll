@@ -0,0 +1,22 @@
+; RUN: llc < %s -mtriple=x86_64-linux -report-machine-memory -o /dev/null 2>&1 | FileCheck %s
+
+; The report is printed before register allocation and again before emission.
+; CHECK: # Memory usage of machine function f:
+; CHECK-NEXT: 1 blocks
+; CHECK-NEXT: instructions
+; CHECK-NEXT: operands {{.*}} slots allocated
+; CHECK-NEXT: 1 memoperands
+; CHECK-NEXT: virtual registers
+; CHECK-NEXT: allocator total
+; CHECK: # Memory usage of machine function f:
+
+define i32 @f(i32* %p, i32 %n) nounwind {
+entry:
+  %c = icmp eq i32 %n, 0
+  br i1 %c, label %exit, label %exit
+
+exit:
+  %v = load i32* %p
+  %r = add i32 %v, %n
+  ret i32 %r
+}
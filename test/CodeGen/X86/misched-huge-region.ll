@@ -0,0 +1,71 @@
+; RUN: llc < %s -march=x86-64 -mcpu=core2 -enable-misched -verify-machineinstrs \
+; RUN:     -sched-huge-region=16 -sched-huge-region-bucket=4 -stats 2>&1 \
+; RUN:     | FileCheck %s
+; RUN: llc < %s -march=x86-64 -mcpu=core2 -enable-misched \
+; RUN:     -sched-huge-region=16 -time-passes -o /dev/null 2>&1 \
+; RUN:     | FileCheck %s -check-prefix=TIME
+; REQUIRES: asserts
+;
+; Regions above the -sched-huge-region threshold are scheduled with bucketed
+; memory chains and a bounded candidate search. The may-alias accesses through
+; %p and %q must still stay in order.
+
+; CHECK: test:
+; CHECK: movl (%rdi), [[R0:%[a-z0-9]+]]
+; CHECK: movl [[R0]], (%rsi)
+; CHECK: movl 4(%rdi), [[R1:%[a-z0-9]+]]
+; CHECK: movl [[R1]], 4(%rsi)
+; CHECK: movl 8(%rdi), [[R2:%[a-z0-9]+]]
+; CHECK: movl [[R2]], 8(%rsi)
+; CHECK: movl 12(%rdi), [[R3:%[a-z0-9]+]]
+; CHECK: movl [[R3]], 12(%rsi)
+; CHECK: 1 misched - Number of regions using the huge region DAG model
+
+; TIME: Machine Scheduler Regions
+; TIME-DAG: Build Scheduling DAG
+; TIME-DAG: List Scheduling
+
+define void @test(i32* %p, i32* %q) nounwind {
+entry:
+  %p0 = getelementptr i32* %p, i64 0
+  %q0 = getelementptr i32* %q, i64 0
+  %v0 = load i32* %p0
+  store i32 %v0, i32* %q0
+  %p1 = getelementptr i32* %p, i64 1
+  %q1 = getelementptr i32* %q, i64 1
+  %v1 = load i32* %p1
+  store i32 %v1, i32* %q1
+  %p2 = getelementptr i32* %p, i64 2
+  %q2 = getelementptr i32* %q, i64 2
+  %v2 = load i32* %p2
+  store i32 %v2, i32* %q2
+  %p3 = getelementptr i32* %p, i64 3
+  %q3 = getelementptr i32* %q, i64 3
+  %v3 = load i32* %p3
+  store i32 %v3, i32* %q3
+  %p4 = getelementptr i32* %p, i64 4
+  %q4 = getelementptr i32* %q, i64 4
+  %v4 = load i32* %p4
+  store i32 %v4, i32* %q4
+  %p5 = getelementptr i32* %p, i64 5
+  %q5 = getelementptr i32* %q, i64 5
+  %v5 = load i32* %p5
+  store i32 %v5, i32* %q5
+  %p6 = getelementptr i32* %p, i64 6
+  %q6 = getelementptr i32* %q, i64 6
+  %v6 = load i32* %p6
+  store i32 %v6, i32* %q6
+  %p7 = getelementptr i32* %p, i64 7
+  %q7 = getelementptr i32* %q, i64 7
+  %v7 = load i32* %p7
+  store i32 %v7, i32* %q7
+  %p8 = getelementptr i32* %p, i64 8
+  %q8 = getelementptr i32* %q, i64 8
+  %v8 = load i32* %p8
+  store i32 %v8, i32* %q8
+  %p9 = getelementptr i32* %p, i64 9
+  %q9 = getelementptr i32* %q, i64 9
+  %v9 = load i32* %p9
+  store i32 %v9, i32* %q9
+  ret void
+}
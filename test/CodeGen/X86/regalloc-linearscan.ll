@@ -0,0 +1,56 @@
+; RUN: llc < %s -mtriple=x86_64-apple-macosx -regalloc=linearscan -verify-machineinstrs | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-apple-macosx -O1 -debug-pass=Structure -o /dev/null 2>&1 | FileCheck %s -check-prefix=O1
+; RUN: llc < %s -mtriple=x86_64-apple-macosx -O2 -debug-pass=Structure -o /dev/null 2>&1 | FileCheck %s -check-prefix=O2
+
+; O1: Greedy Register Allocator
+; O2: Greedy Register Allocator
+
+; The sum stays in a register across the loop.
+; CHECK: sum:
+; CHECK: [[LOOP:LBB0_[0-9]+]]:
+; CHECK-NOT: (%rsp)
+; CHECK: jne [[LOOP]]
+
+define i64 @sum(i64* %p, i64 %n) nounwind {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %s = phi i64 [ 0, %entry ], [ %s.next, %loop ]
+  %addr = getelementptr i64* %p, i64 %i
+  %v = load i64* %addr
+  %s.next = add i64 %s, %v
+  %i.next = add i64 %i, 1
+  %done = icmp eq i64 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret i64 %s.next
+}
+
+; Values live across a call are spilled or kept in callee-saved registers.
+; CHECK: pressure:
+; CHECK: callq _g
+; CHECK: ret
+
+declare void @g()
+
+define i64 @pressure(i64 %a, i64 %b, i64 %c, i64 %d, i64 %e, i64 %f) nounwind {
+entry:
+  %x1 = mul i64 %a, %b
+  %x2 = mul i64 %c, %d
+  %x3 = mul i64 %e, %f
+  %x4 = add i64 %a, %f
+  %x5 = add i64 %b, %e
+  %x6 = add i64 %c, %d
+  %x7 = xor i64 %a, %c
+  call void @g()
+  %y1 = add i64 %x1, %x2
+  %y2 = add i64 %x3, %x4
+  %y3 = add i64 %x5, %x6
+  %y4 = add i64 %y1, %y2
+  %y5 = add i64 %y3, %x7
+  %r = add i64 %y4, %y5
+  ret i64 %r
+}
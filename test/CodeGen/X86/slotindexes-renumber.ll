@@ -0,0 +1,183 @@
+; RUN: llc < %s -march=x86-64 -stats 2>&1 | FileCheck %s
+; REQUIRES: asserts
+
+; Spilling the phi operands inserts a copy for each of them into the empty
+; block %y.  Those instructions all land in the same gap of the SlotIndexes
+; list, which should be absorbed by the spare label space without any
+; renumbering.
+
+; CHECK: regalloc - Number of spills inserted
+; CHECK-NOT: slotindexes
+
+define i64 @f(i64* %p, i1 %c) nounwind {
+entry:
+  %a0 = getelementptr i64* %p, i64 0
+  %v0 = load volatile i64* %a0
+  %a1 = getelementptr i64* %p, i64 1
+  %v1 = load volatile i64* %a1
+  %a2 = getelementptr i64* %p, i64 2
+  %v2 = load volatile i64* %a2
+  %a3 = getelementptr i64* %p, i64 3
+  %v3 = load volatile i64* %a3
+  %a4 = getelementptr i64* %p, i64 4
+  %v4 = load volatile i64* %a4
+  %a5 = getelementptr i64* %p, i64 5
+  %v5 = load volatile i64* %a5
+  %a6 = getelementptr i64* %p, i64 6
+  %v6 = load volatile i64* %a6
+  %a7 = getelementptr i64* %p, i64 7
+  %v7 = load volatile i64* %a7
+  %a8 = getelementptr i64* %p, i64 8
+  %v8 = load volatile i64* %a8
+  %a9 = getelementptr i64* %p, i64 9
+  %v9 = load volatile i64* %a9
+  %a10 = getelementptr i64* %p, i64 10
+  %v10 = load volatile i64* %a10
+  %a11 = getelementptr i64* %p, i64 11
+  %v11 = load volatile i64* %a11
+  %a12 = getelementptr i64* %p, i64 12
+  %v12 = load volatile i64* %a12
+  %a13 = getelementptr i64* %p, i64 13
+  %v13 = load volatile i64* %a13
+  %a14 = getelementptr i64* %p, i64 14
+  %v14 = load volatile i64* %a14
+  %a15 = getelementptr i64* %p, i64 15
+  %v15 = load volatile i64* %a15
+  %a16 = getelementptr i64* %p, i64 16
+  %v16 = load volatile i64* %a16
+  %a17 = getelementptr i64* %p, i64 17
+  %v17 = load volatile i64* %a17
+  %a18 = getelementptr i64* %p, i64 18
+  %v18 = load volatile i64* %a18
+  %a19 = getelementptr i64* %p, i64 19
+  %v19 = load volatile i64* %a19
+  %a20 = getelementptr i64* %p, i64 20
+  %v20 = load volatile i64* %a20
+  %a21 = getelementptr i64* %p, i64 21
+  %v21 = load volatile i64* %a21
+  %a22 = getelementptr i64* %p, i64 22
+  %v22 = load volatile i64* %a22
+  %a23 = getelementptr i64* %p, i64 23
+  %v23 = load volatile i64* %a23
+  %a24 = getelementptr i64* %p, i64 24
+  %v24 = load volatile i64* %a24
+  %a25 = getelementptr i64* %p, i64 25
+  %v25 = load volatile i64* %a25
+  %a26 = getelementptr i64* %p, i64 26
+  %v26 = load volatile i64* %a26
+  %a27 = getelementptr i64* %p, i64 27
+  %v27 = load volatile i64* %a27
+  %a28 = getelementptr i64* %p, i64 28
+  %v28 = load volatile i64* %a28
+  %a29 = getelementptr i64* %p, i64 29
+  %v29 = load volatile i64* %a29
+  %a30 = getelementptr i64* %p, i64 30
+  %v30 = load volatile i64* %a30
+  %a31 = getelementptr i64* %p, i64 31
+  %v31 = load volatile i64* %a31
+  br i1 %c, label %x, label %y
+
+x:
+  %w0 = add i64 %v0, 1
+  %w1 = add i64 %v1, 1
+  %w2 = add i64 %v2, 1
+  %w3 = add i64 %v3, 1
+  %w4 = add i64 %v4, 1
+  %w5 = add i64 %v5, 1
+  %w6 = add i64 %v6, 1
+  %w7 = add i64 %v7, 1
+  %w8 = add i64 %v8, 1
+  %w9 = add i64 %v9, 1
+  %w10 = add i64 %v10, 1
+  %w11 = add i64 %v11, 1
+  %w12 = add i64 %v12, 1
+  %w13 = add i64 %v13, 1
+  %w14 = add i64 %v14, 1
+  %w15 = add i64 %v15, 1
+  %w16 = add i64 %v16, 1
+  %w17 = add i64 %v17, 1
+  %w18 = add i64 %v18, 1
+  %w19 = add i64 %v19, 1
+  %w20 = add i64 %v20, 1
+  %w21 = add i64 %v21, 1
+  %w22 = add i64 %v22, 1
+  %w23 = add i64 %v23, 1
+  %w24 = add i64 %v24, 1
+  %w25 = add i64 %v25, 1
+  %w26 = add i64 %v26, 1
+  %w27 = add i64 %v27, 1
+  %w28 = add i64 %v28, 1
+  %w29 = add i64 %v29, 1
+  %w30 = add i64 %v30, 1
+  %w31 = add i64 %v31, 1
+  br label %m
+
+y:
+  br label %m
+
+m:
+  %m0 = phi i64 [ %w0, %x ], [ %v0, %y ]
+  %m1 = phi i64 [ %w1, %x ], [ %v1, %y ]
+  %m2 = phi i64 [ %w2, %x ], [ %v2, %y ]
+  %m3 = phi i64 [ %w3, %x ], [ %v3, %y ]
+  %m4 = phi i64 [ %w4, %x ], [ %v4, %y ]
+  %m5 = phi i64 [ %w5, %x ], [ %v5, %y ]
+  %m6 = phi i64 [ %w6, %x ], [ %v6, %y ]
+  %m7 = phi i64 [ %w7, %x ], [ %v7, %y ]
+  %m8 = phi i64 [ %w8, %x ], [ %v8, %y ]
+  %m9 = phi i64 [ %w9, %x ], [ %v9, %y ]
+  %m10 = phi i64 [ %w10, %x ], [ %v10, %y ]
+  %m11 = phi i64 [ %w11, %x ], [ %v11, %y ]
+  %m12 = phi i64 [ %w12, %x ], [ %v12, %y ]
+  %m13 = phi i64 [ %w13, %x ], [ %v13, %y ]
+  %m14 = phi i64 [ %w14, %x ], [ %v14, %y ]
+  %m15 = phi i64 [ %w15, %x ], [ %v15, %y ]
+  %m16 = phi i64 [ %w16, %x ], [ %v16, %y ]
+  %m17 = phi i64 [ %w17, %x ], [ %v17, %y ]
+  %m18 = phi i64 [ %w18, %x ], [ %v18, %y ]
+  %m19 = phi i64 [ %w19, %x ], [ %v19, %y ]
+  %m20 = phi i64 [ %w20, %x ], [ %v20, %y ]
+  %m21 = phi i64 [ %w21, %x ], [ %v21, %y ]
+  %m22 = phi i64 [ %w22, %x ], [ %v22, %y ]
+  %m23 = phi i64 [ %w23, %x ], [ %v23, %y ]
+  %m24 = phi i64 [ %w24, %x ], [ %v24, %y ]
+  %m25 = phi i64 [ %w25, %x ], [ %v25, %y ]
+  %m26 = phi i64 [ %w26, %x ], [ %v26, %y ]
+  %m27 = phi i64 [ %w27, %x ], [ %v27, %y ]
+  %m28 = phi i64 [ %w28, %x ], [ %v28, %y ]
+  %m29 = phi i64 [ %w29, %x ], [ %v29, %y ]
+  %m30 = phi i64 [ %w30, %x ], [ %v30, %y ]
+  %m31 = phi i64 [ %w31, %x ], [ %v31, %y ]
+  %s1 = xor i64 %m0, %m1
+  %s2 = xor i64 %s1, %m2
+  %s3 = xor i64 %s2, %m3
+  %s4 = xor i64 %s3, %m4
+  %s5 = xor i64 %s4, %m5
+  %s6 = xor i64 %s5, %m6
+  %s7 = xor i64 %s6, %m7
+  %s8 = xor i64 %s7, %m8
+  %s9 = xor i64 %s8, %m9
+  %s10 = xor i64 %s9, %m10
+  %s11 = xor i64 %s10, %m11
+  %s12 = xor i64 %s11, %m12
+  %s13 = xor i64 %s12, %m13
+  %s14 = xor i64 %s13, %m14
+  %s15 = xor i64 %s14, %m15
+  %s16 = xor i64 %s15, %m16
+  %s17 = xor i64 %s16, %m17
+  %s18 = xor i64 %s17, %m18
+  %s19 = xor i64 %s18, %m19
+  %s20 = xor i64 %s19, %m20
+  %s21 = xor i64 %s20, %m21
+  %s22 = xor i64 %s21, %m22
+  %s23 = xor i64 %s22, %m23
+  %s24 = xor i64 %s23, %m24
+  %s25 = xor i64 %s24, %m25
+  %s26 = xor i64 %s25, %m26
+  %s27 = xor i64 %s26, %m27
+  %s28 = xor i64 %s27, %m28
+  %s29 = xor i64 %s28, %m29
+  %s30 = xor i64 %s29, %m30
+  %s31 = xor i64 %s30, %m31
+  ret i64 %s31
+}
@@ -0,0 +1,54 @@
+; RUN: rm -rf %t.cache
+; RUN: %lli_mcjit -object-cache-dir=%t.cache -time-passes %s 2>&1 \
+; RUN:   | FileCheck -check-prefix=MISS %s
+; RUN: ls %t.cache | FileCheck %s
+; RUN: %lli_mcjit -object-cache-dir=%t.cache -time-passes %s 2>&1 \
+; RUN:   | FileCheck -check-prefix=HIT %s
+; RUN: ls %t.cache | count 1
+
+; Code generation rewrites the loop below before the object is written, so
+; the object must be stored under the key it was looked up by for the second
+; run to find it.
+
+; CHECK: {{^[0-9a-f]+-[0-9]+\.o$}}
+
+; MISS: DAG->DAG
+
+; HIT-NOT: DAG->DAG
+; HIT: LLVM IR Parsing
+; HIT-NOT: DAG->DAG
+
+define i32 @sum(i32* %p, i32 %n) {
+entry:
+  %cmp = icmp sgt i32 %n, 0
+  br i1 %cmp, label %loop, label %exit
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %s = phi i32 [ 0, %entry ], [ %s.next, %loop ]
+  %a = getelementptr i32* %p, i32 %i
+  %v = load i32* %a
+  %s.next = add i32 %s, %v
+  %i.next = add i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i32 [ 0, %entry ], [ %s.next, %loop ]
+  ret i32 %r
+}
+
+define i32 @main() {
+entry:
+  %buf = alloca [4 x i32]
+  %p = getelementptr [4 x i32]* %buf, i32 0, i32 0
+  store i32 0, i32* %p
+  %p1 = getelementptr [4 x i32]* %buf, i32 0, i32 1
+  store i32 0, i32* %p1
+  %p2 = getelementptr [4 x i32]* %buf, i32 0, i32 2
+  store i32 0, i32* %p2
+  %p3 = getelementptr [4 x i32]* %buf, i32 0, i32 3
+  store i32 0, i32* %p3
+  %r = call i32 @sum(i32* %p, i32 4)
+  ret i32 %r
+}
@@ -0,0 +1,13 @@
+; RUN: %lli -O1 -use-linear-scan -debug-pass=Structure %s 2>&1 \
+; RUN:   | FileCheck %s -check-prefix=LINEARSCAN
+; RUN: %lli -O1 -debug-pass=Structure %s 2>&1 | FileCheck %s -check-prefix=GREEDY
+
+; The JIT opts in to the linear scan allocator at -O1; the default stays greedy.
+; LINEARSCAN: Linear Scan Register Allocator
+; GREEDY: Greedy Register Allocator
+
+define i32 @main() {
+  %a = add i32 1, 2
+  %b = sub i32 %a, 3
+  ret i32 %b
+}
@@ -0,0 +1,41 @@
+; RUN: llvm-as %s -o %t.bc
+; RUN: llvm-lto -disable-opt -partitions=2 -exported-symbol=f1 \
+; RUN:   -exported-symbol=f2 -o %t.o %t.bc
+; RUN: llvm-nm %t.o | FileCheck %s
+; RUN: not ls %t.o.0
+
+; @f2 takes the address of a block in @f1, which is in the other partition,
+; so the module is compiled into a single object.  (@f2 comes first because
+; the LTO linker cannot yet map a blockaddress into a function body it has
+; already moved.)
+
+; CHECK: T f1
+; CHECK: T f2
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare i32 @ext(i32)
+
+define i8* @f2() {
+  %x = call i32 @ext(i32 0)
+  %y = call i32 @ext(i32 %x)
+  %z = call i32 @ext(i32 %y)
+  %w = call i32 @ext(i32 %z)
+  %a = call i32 @ext(i32 %w)
+  %b = call i32 @ext(i32 %a)
+  %c = call i32 @ext(i32 %b)
+  %d = call i32 @ext(i32 %c)
+  %e = call i32 @ext(i32 %d)
+  ret i8* blockaddress(@f1, %target)
+}
+
+define i32 @f1(i32 %x) {
+entry:
+  %a = call i32 @ext(i32 %x)
+  br label %target
+
+target:
+  %e = call i32 @ext(i32 %a)
+  ret i32 %e
+}
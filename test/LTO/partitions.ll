@@ -0,0 +1,104 @@
+; RUN: llvm-as %s -o %t.bc
+; RUN: llvm-lto -disable-opt -partitions=2 -exported-symbol=f1 \
+; RUN:   -exported-symbol=f2 -exported-symbol=f2_alias -o %t.o %t.bc
+; RUN: llvm-nm %t.o.0 | FileCheck -check-prefix=NM0 %s
+; RUN: llvm-nm %t.o.1 | FileCheck -check-prefix=NM1 %s
+; RUN: llvm-readobj -t %t.o.0 | FileCheck -check-prefix=SYM %s
+; RUN: llvm-readobj -s %t.o.0 | FileCheck -check-prefix=CTORS %s
+; RUN: llvm-readobj -s %t.o.1 | FileCheck -check-prefix=NOCTORS %s
+; RUN: sed -e 's/x86_64-unknown-linux-gnu/x86_64-apple-macosx10.8.0/' %s \
+; RUN:   | llvm-as -o %t.macho.bc
+; RUN: llvm-lto -disable-opt -partitions=2 -exported-symbol=_f1 \
+; RUN:   -exported-symbol=_f2 -exported-symbol=_f2_alias -o %t.macho.o \
+; RUN:   %t.macho.bc
+; RUN: llvm-readobj -t %t.macho.o.1 | FileCheck -check-prefix=USED %s
+
+; @f1 and @helper form the first partition, everything else the second.
+; Locals referenced from the other partition become hidden globals, the
+; alias is only defined where @f2 is, and llvm.global_ctors and the module
+; asm are only emitted by the first partition.  Each partition keeps the
+; llvm.used entries it defines, so @kept stays marked where it is defined.
+
+; NM0: T asm_sym
+; NM0: B counter.llvm_lto
+; NM0: U ctor.llvm_lto
+; NM0: T f1
+; NM0: U f2_alias
+; NM0: T helper.llvm_lto
+; NM0-NOT: kept
+
+; NM1-NOT: asm_sym
+; NM1: U counter.llvm_lto
+; NM1: T ctor.llvm_lto
+; NM1: T f2
+; NM1: T f2_alias
+; NM1: U helper.llvm_lto
+; NM1: T kept.llvm_lto
+
+; SYM: Name: helper.llvm_lto
+; SYM-NEXT: Value:
+; SYM-NEXT: Size:
+; SYM-NEXT: Binding: Global
+; SYM-NEXT: Type: Function
+; SYM-NEXT: Other: 2
+
+; USED: Name: _kept.llvm_lto
+; USED-NOT: Name:
+; USED: NoDeadStrip
+
+; CTORS: Name: .ctors
+; NOCTORS-NOT: Name: .ctors
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+module asm ".text"
+module asm ".globl asm_sym"
+module asm "asm_sym:"
+
+@counter = internal global i32 0
+@llvm.used = appending global [1 x i8*] [i8* bitcast (void ()* @kept to i8*)], section "llvm.metadata"
+@llvm.global_ctors = appending global [1 x { i32, void ()* }] [{ i32, void ()* } { i32 65535, void ()* @ctor }]
+
+@f2_alias = alias i32 (i32)* @f2
+
+declare i32 @ext(i32)
+
+define i32 @f1(i32 %x) {
+  %a = call i32 @ext(i32 %x)
+  %b = call i32 @ext(i32 %a)
+  %c = call i32 @ext(i32 %b)
+  %d = call i32 @ext(i32 %c)
+  %e = call i32 @ext(i32 %d)
+  %h = call i32 @helper(i32 %e)
+  %n = load i32* @counter
+  %s = add i32 %h, %n
+  %r = call i32 @f2_alias(i32 %s)
+  ret i32 %r
+}
+
+define internal i32 @helper(i32 %x) {
+  %r = call i32 @ext(i32 %x)
+  ret i32 %r
+}
+
+define i32 @f2(i32 %x) {
+  %a = call i32 @ext(i32 %x)
+  %b = call i32 @ext(i32 %a)
+  %c = call i32 @ext(i32 %b)
+  %d = call i32 @ext(i32 %c)
+  %e = call i32 @ext(i32 %d)
+  %h = call i32 @helper(i32 %e)
+  store i32 %h, i32* @counter
+  ret i32 %h
+}
+
+define internal void @kept() {
+  ret void
+}
+
+define internal void @ctor() {
+  %r = call i32 @ext(i32 0)
+  store i32 %r, i32* @counter
+  ret void
+}
@@ -0,0 +1,37 @@
+; Compile several jobs through one llc process and check that each produces
+; the same code as a separate run, and that options do not leak between jobs.
+; RUN: echo "%s -mtriple=x86_64-unknown-unknown -o %t1.s" > %t.jobs
+; RUN: echo "%s -mtriple=x86_64-unknown-unknown -O0 -o %t2.s" >> %t.jobs
+; RUN: echo "" >> %t.jobs
+; RUN: echo "%s -mtriple=x86_64-unknown-unknown -o %t3.s" >> %t.jobs
+; RUN: echo "%t.missing.ll -o %t4.s" >> %t.jobs
+; RUN: echo "%s -o -" >> %t.jobs
+; RUN: echo "%s -mtriple=i686-unknown-unknown -o %t5.s" >> %t.jobs
+; RUN: llc -server < %t.jobs 2> %t.err | FileCheck %s
+; RUN: FileCheck %s -check-prefix=ERR < %t.err
+; RUN: llc -mtriple=x86_64-unknown-unknown %s -o %t.ref1.s
+; RUN: llc -mtriple=x86_64-unknown-unknown -O0 %s -o %t.ref2.s
+; RUN: llc -mtriple=i686-unknown-unknown %s -o %t.ref5.s
+; RUN: diff %t.ref1.s %t1.s
+; RUN: diff %t.ref2.s %t2.s
+; RUN: diff %t.ref1.s %t3.s
+; RUN: diff %t.ref5.s %t5.s
+
+; CHECK: job 1 exit 0 time
+; CHECK: job 2 exit 0 time
+; CHECK: job 3 exit 0 time
+; CHECK: job 4 exit 1 time
+; CHECK: job 5 exit 1 time
+; CHECK: job 6 exit 0 time
+
+; ERR: missing.ll
+; ERR: compile server jobs must name their input and output files
+
+define i32 @f(i32 %a, i32 %b) {
+entry:
+  %c = alloca i32
+  store i32 %a, i32* %c
+  %d = load i32* %c
+  %e = add i32 %d, %b
+  ret i32 %e
+}
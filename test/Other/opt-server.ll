@@ -0,0 +1,25 @@
+; Run several jobs through one opt process and check that options given to
+; one job do not affect the next.
+; RUN: echo "%s -instcombine -S -o %t1.ll" > %t.jobs
+; RUN: echo "%s -S -o %t2.ll" >> %t.jobs
+; RUN: echo "%s -S" >> %t.jobs
+; RUN: echo "%s -disable-output -instcombine" >> %t.jobs
+; RUN: opt -server < %t.jobs 2> %t.err | FileCheck %s
+; RUN: FileCheck %s -check-prefix=ERR < %t.err
+; RUN: FileCheck %s -check-prefix=COMBINED < %t1.ll
+; RUN: FileCheck %s -check-prefix=PLAIN < %t2.ll
+
+; CHECK: job 1 exit 0 time
+; CHECK: job 2 exit 0 time
+; CHECK: job 3 exit 1 time
+; CHECK: job 4 exit 0 time
+
+; ERR: server jobs must name their input and output files
+
+; COMBINED: ret i32 %a
+; PLAIN: add i32 %a, 0
+
+define i32 @f(i32 %a) {
+  %b = add i32 %a, 0
+  ret i32 %b
+}
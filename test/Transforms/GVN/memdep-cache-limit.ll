@@ -0,0 +1,32 @@
+; REQUIRES: asserts
+; RUN: opt < %s -basicaa -gvn -memdep-cache-entries=1 -S | FileCheck %s
+; RUN: opt < %s -basicaa -gvn -memdep-cache-entries=1 -stats -disable-output 2>&1 | FileCheck %s --check-prefix=STATS
+
+; Evicting cached non-local pointer dependencies between queries must not
+; lose any redundant loads.
+
+; STATS: memdep - Number of non-local ptr responses evicted from the cache
+
+define i32 @test(i32* noalias %p, i32* noalias %q, i1 %c) {
+entry:
+  br i1 %c, label %a, label %b
+
+a:
+  store i32 1, i32* %p
+  store i32 2, i32* %q
+  br label %join
+
+b:
+  store i32 3, i32* %p
+  store i32 4, i32* %q
+  br label %join
+
+join:
+; CHECK: join:
+; CHECK-NOT: load
+; CHECK: ret
+  %x = load i32* %p
+  %y = load i32* %q
+  %r = add i32 %x, %y
+  ret i32 %r
+}
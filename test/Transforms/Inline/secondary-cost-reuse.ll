@@ -0,0 +1,80 @@
+; RUN: opt < %s -inline -stats -S 2>&1 | FileCheck %s
+; REQUIRES: asserts
+
+; Inlining @c into the internal function @b would stop @b from being inlined
+; into @a1 and @a2, so the second call to @c is left in place.  Each time the
+; inliner rejects it, the costs of the calls to @b are looked up again; they
+; must only be computed once while the IR is unchanged.
+
+; CHECK: define i32 @a1
+; CHECK-NOT: call i32 @b
+; CHECK: define i32 @a2
+; CHECK-NOT: call i32 @b
+; CHECK-NOT: define internal i32 @b
+
+; CHECK: 2 inline - Number of caller-caller costs reused
+; CHECK: 4 inline - Number of caller-callers analyzed
+
+define i32 @c(i32 %x) {
+  %c0 = mul i32 %x, 3
+  %c1 = mul i32 %c0, 4
+  %c2 = mul i32 %c1, 5
+  %c3 = mul i32 %c2, 6
+  %c4 = mul i32 %c3, 7
+  %c5 = mul i32 %c4, 8
+  %c6 = mul i32 %c5, 9
+  %c7 = mul i32 %c6, 10
+  %c8 = mul i32 %c7, 11
+  %c9 = mul i32 %c8, 12
+  %c10 = mul i32 %c9, 13
+  %c11 = mul i32 %c10, 14
+  %c12 = mul i32 %c11, 15
+  %c13 = mul i32 %c12, 16
+  %c14 = mul i32 %c13, 17
+  %c15 = mul i32 %c14, 18
+  %c16 = mul i32 %c15, 19
+  %c17 = mul i32 %c16, 20
+  %c18 = mul i32 %c17, 21
+  %c19 = mul i32 %c18, 22
+  %c20 = mul i32 %c19, 23
+  %c21 = mul i32 %c20, 24
+  %c22 = mul i32 %c21, 25
+  %c23 = mul i32 %c22, 26
+  %c24 = mul i32 %c23, 27
+  %c25 = mul i32 %c24, 28
+  %c26 = mul i32 %c25, 29
+  %c27 = mul i32 %c26, 30
+  %c28 = mul i32 %c27, 31
+  %c29 = mul i32 %c28, 32
+  %c30 = mul i32 %c29, 33
+  %c31 = mul i32 %c30, 34
+  %c32 = mul i32 %c31, 35
+  %c33 = mul i32 %c32, 36
+  %c34 = mul i32 %c33, 37
+  %c35 = mul i32 %c34, 38
+  %c36 = mul i32 %c35, 39
+  %c37 = mul i32 %c36, 40
+  ret i32 %c37
+}
+
+define internal i32 @b(i32 %x) {
+  %r1 = call i32 @c(i32 %x)
+  %r2 = call i32 @c(i32 %r1)
+  %b0 = xor i32 %r2, 7
+  %b1 = xor i32 %b0, 8
+  %b2 = xor i32 %b1, 9
+  %b3 = xor i32 %b2, 10
+  %b4 = xor i32 %b3, 11
+  %b5 = xor i32 %b4, 12
+  ret i32 %b5
+}
+
+define i32 @a1(i32 %x) {
+  %r = call i32 @b(i32 %x)
+  ret i32 %r
+}
+
+define i32 @a2(i32 %x) {
+  %r = call i32 @b(i32 %x)
+  ret i32 %r
+}
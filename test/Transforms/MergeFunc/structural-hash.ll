@@ -0,0 +1,56 @@
+; RUN: opt -S -mergefunc < %s | FileCheck %s
+
+; Functions with the same signature are told apart by the structural hash, but
+; everything FunctionComparator treats as equivalent must still hash the same.
+
+; Different constants: not merged.
+define i32 @add1(i32 %x) {
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+; CHECK: define i32 @add1(
+; CHECK-NEXT: add i32 %x, 1
+; CHECK: define i32 @add2(
+; CHECK-NEXT: add i32 %x, 2
+define i32 @add2(i32 %x) {
+  %r = add i32 %x, 2
+  ret i32 %r
+}
+
+; CHECK: define i32 @add2_dup(
+; CHECK-NEXT: tail call i32 @add2(i32 %0)
+define i32 @add2_dup(i32 %x) {
+  %r = add i32 %x, 2
+  ret i32 %r
+}
+
+; Self-recursive functions refer to different globals but are equal.
+define i32 @rec1(i32 %x) {
+  %c = icmp eq i32 %x, 0
+  br i1 %c, label %done, label %more
+
+more:
+  %y = sub i32 %x, 1
+  %r = call i32 @rec1(i32 %y)
+  ret i32 %r
+
+done:
+  ret i32 0
+}
+
+; The block list order does not matter, only the CFG.
+; CHECK: define i32 @rec2(
+; CHECK-NEXT: tail call i32 @rec1(i32 %0)
+define i32 @rec2(i32 %x) {
+  %c = icmp eq i32 %x, 0
+  br i1 %c, label %done, label %more
+
+done:
+  ret i32 0
+
+more:
+  %y = sub i32 %x, 1
+  %r = call i32 @rec2(i32 %y)
+  ret i32 %r
+}
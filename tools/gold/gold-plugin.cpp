@@ -77,6 +77,7 @@ namespace options {
   static std::string extra_library_path;
   static std::string triple;
   static std::string mcpu;
+  static unsigned partitions = 1;
   // Additional options to pass into the code generator.
   // Note: This array will contain all plugin options which are not claimed
   // as plugin exclusive to pass to the code generator.
@@ -94,6 +95,12 @@ namespace options {
       generate_api_file = true;
     } else if (opt.startswith("mcpu=")) {
       mcpu = opt.substr(strlen("mcpu="));
+    } else if (opt.startswith("partitions=")) {
+      if (opt.substr(strlen("partitions=")).getAsInteger(10, partitions) ||
+          partitions == 0) {
+        (*message)(LDPL_WARNING, "Ignoring invalid option %s", opt_);
+        partitions = 1;
+      }
     } else if (opt.startswith("extra-library-path=")) {
       extra_library_path = opt.substr(strlen("extra_library_path="));
     } else if (opt.startswith("mtriple=")) {
@@ -420,10 +427,16 @@ static ld_plugin_status all_symbols_read_hook(void) {
     if (options::generate_bc_file == options::BC_ONLY)
       exit(0);
   }
-  const char *objPath;
-  if (lto_codegen_compile_to_file(code_gen, &objPath)) {
+  // Copy the object file names, they are owned by code_gen.
+  std::vector<std::string> objPaths;
+  const char **objNames = 0;
+  unsigned numObjs;
+  lto_codegen_set_partitions(code_gen, options::partitions);
+  if (lto_codegen_compile_partitions_to_files(code_gen, &objNames, &numObjs)) {
     (*message)(LDPL_ERROR, "Could not produce a combined object file\n");
+    numObjs = 0;
   }
+  objPaths.assign(objNames, objNames + numObjs);
 
   lto_codegen_dispose(code_gen);
   for (std::list<claimed_file>::iterator I = Modules.begin(),
@@ -434,10 +447,16 @@ static ld_plugin_status all_symbols_read_hook(void) {
     }
   }
 
-  if ((*add_input_file)(objPath) != LDPS_OK) {
-    (*message)(LDPL_ERROR, "Unable to add .o file to the link.");
-    (*message)(LDPL_ERROR, "File left behind in: %s", objPath);
-    return LDPS_ERR;
+  for (unsigned i = 0, e = objPaths.size(); i != e; ++i) {
+    const char *objPath = objPaths[i].c_str();
+    if ((*add_input_file)(objPath) != LDPS_OK) {
+      (*message)(LDPL_ERROR, "Unable to add .o file to the link.");
+      (*message)(LDPL_ERROR, "File left behind in: %s", objPath);
+      return LDPS_ERR;
+    }
+
+    if (options::obj_path.empty())
+      Cleanup.push_back(sys::Path(objPath));
   }
 
   if (!options::extra_library_path.empty() &&
@@ -446,9 +465,6 @@ static ld_plugin_status all_symbols_read_hook(void) {
     return LDPS_ERR;
   }
 
-  if (options::obj_path.empty())
-    Cleanup.push_back(sys::Path(objPath));
-
   return LDPS_OK;
 }
 
@@ -27,6 +27,8 @@
 #include "llvm/PassManager.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/ManagedStatic.h"
@@ -36,9 +38,11 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Target/TargetLibraryInfo.h"
 #include "llvm/Target/TargetMachine.h"
+#include <cstdio>
 #include <memory>
 using namespace llvm;
 
@@ -77,8 +81,134 @@ DisableSimplifyLibCalls("disable-simplify-libcalls",
                         cl::desc("Disable simplify-libcalls"),
                         cl::init(false));
 
+static cl::opt<bool>
+CompileServer("server",
+              cl::desc("Read compile jobs from standard input, one set of "
+                       "arguments per line"));
+
 static int compileModule(char**, LLVMContext&);
 
+namespace {
+/// CachedTargetMachine - A TargetMachine kept alive between compile server
+/// jobs, along with the settings it was created with.
+struct CachedTargetMachine {
+  std::string Triple;
+  std::string CPU;
+  std::string Features;
+  TargetOptions Options;
+  Reloc::Model RM;
+  CodeModel::Model CM;
+  CodeGenOpt::Level OL;
+
+  // The MC flags as the target left them after construction.  Each job
+  // starts from these before applying its own options.
+  bool UseLoc;
+  bool UseCFI;
+  bool UseDwarfDirectory;
+  bool RelaxAll;
+
+  TargetMachine *TM;
+};
+}
+
+/// TargetMachineCache - Target machines created by earlier compile server
+/// jobs.  This is only used in -server mode.
+static std::vector<CachedTargetMachine> *TargetMachineCache = 0;
+
+/// getCachedTargetMachine - Return a target machine for the given settings,
+/// reusing one from an earlier job if possible.  The machine is owned by the
+/// cache.
+static TargetMachine *getCachedTargetMachine(const Target *TheTarget,
+                                             const std::string &TheTriple,
+                                             const std::string &FeaturesStr,
+                                             TargetOptions &Options,
+                                             CodeGenOpt::Level OLvl) {
+  for (unsigned i = 0, e = TargetMachineCache->size(); i != e; ++i) {
+    CachedTargetMachine &Entry = (*TargetMachineCache)[i];
+    if (Entry.Triple != TheTriple || Entry.CPU != MCPU ||
+        Entry.Features != FeaturesStr || Entry.RM != RelocModel ||
+        Entry.CM != CMModel || Entry.OL != OLvl || !(Entry.Options == Options))
+      continue;
+
+    TargetMachine *TM = Entry.TM;
+    TM->setMCUseLoc(Entry.UseLoc);
+    TM->setMCUseCFI(Entry.UseCFI);
+    TM->setMCUseDwarfDirectory(Entry.UseDwarfDirectory);
+    TM->setMCRelaxAll(Entry.RelaxAll);
+    return TM;
+  }
+
+  TargetMachine *TM = TheTarget->createTargetMachine(TheTriple, MCPU,
+                                                     FeaturesStr, Options,
+                                                     RelocModel, CMModel,
+                                                     OLvl);
+  if (!TM)
+    return 0;
+
+  CachedTargetMachine Entry;
+  Entry.Triple = TheTriple;
+  Entry.CPU = MCPU;
+  Entry.Features = FeaturesStr;
+  Entry.Options = Options;
+  Entry.RM = RelocModel;
+  Entry.CM = CMModel;
+  Entry.OL = OLvl;
+  Entry.UseLoc = TM->hasMCUseLoc();
+  Entry.UseCFI = TM->hasMCUseCFI();
+  Entry.UseDwarfDirectory = TM->hasMCUseDwarfDirectory();
+  Entry.RelaxAll = TM->hasMCRelaxAll();
+  Entry.TM = TM;
+  TargetMachineCache->push_back(Entry);
+  return TM;
+}
+
+// runCompileServer - Read jobs from standard input, one per line.  Each line
+// holds the arguments of a single llc invocation.  All options are reset
+// before a job's arguments are parsed, so nothing carries over from earlier
+// jobs except the target machines, which are reused when a job asks for the
+// same target configuration.  A line of the form
+//   job <n> exit <status> time <seconds>
+// is written to standard output when each job finishes.
+static int runCompileServer(char **argv) {
+  std::vector<CachedTargetMachine> Cache;
+  TargetMachineCache = &Cache;
+
+  std::string Line;
+  unsigned JobNum = 0;
+  while (ReadLine(stdin, Line)) {
+    if (StringRef(Line).trim().empty())
+      continue;
+    ++JobNum;
+
+    TimeRecord Start = TimeRecord::getCurrentTime(true);
+    cl::ResetAllOptionOccurrences();
+    cl::ParseCommandLineString(argv[0], Line, "llvm system compiler\n");
+
+    int RetVal;
+    if (InputFilename == "-" || OutputFilename == "-") {
+      errs() << argv[0] << ": compile server jobs must name their input "
+             << "and output files\n";
+      RetVal = 1;
+    } else {
+      // Types and constants are uniqued in the context, so every job gets a
+      // fresh one to keep memory use from growing with the number of jobs.
+      LLVMContext Context;
+      RetVal = compileModule(argv, Context);
+    }
+
+    TimeRecord Elapsed = TimeRecord::getCurrentTime(false);
+    Elapsed -= Start;
+    outs() << "job " << JobNum << " exit " << RetVal << " time "
+           << format("%.6f", Elapsed.getWallTime()) << '\n';
+    outs().flush();
+  }
+
+  for (unsigned i = 0, e = Cache.size(); i != e; ++i)
+    delete Cache[i].TM;
+  TargetMachineCache = 0;
+  return 0;
+}
+
 // GetFileNameRoot - Helper function to get the basename of a filename.
 static inline std::string
 GetFileNameRoot(const std::string &InputFilename) {
@@ -189,6 +319,9 @@ int main(int argc, char **argv) {
 
   cl::ParseCommandLineOptions(argc, argv, "llvm system compiler\n");
 
+  if (CompileServer)
+    return runCompileServer(argv);
+
   // Compile the module TimeCompilations times to give better compile time
   // metrics.
   for (unsigned I = TimeCompilations; I; --I)
@@ -281,13 +414,20 @@ static int compileModule(char **argv, LLVMContext &Context) {
   Options.UseInitArray = UseInitArray;
   Options.SSPBufferSize = SSPBufferSize;
 
-  OwningPtr<TargetMachine>
-    target(TheTarget->createTargetMachine(TheTriple.getTriple(),
-                                          MCPU, FeaturesStr, Options,
-                                          RelocModel, CMModel, OLvl));
-  assert(target.get() && "Could not allocate target machine!");
+  OwningPtr<TargetMachine> target;
+  TargetMachine *TM;
+  if (TargetMachineCache && mod) {
+    TM = getCachedTargetMachine(TheTarget, TheTriple.getTriple(), FeaturesStr,
+                                Options, OLvl);
+  } else {
+    target.reset(TheTarget->createTargetMachine(TheTriple.getTriple(),
+                                                MCPU, FeaturesStr, Options,
+                                                RelocModel, CMModel, OLvl));
+    TM = target.get();
+  }
+  assert(TM && "Could not allocate target machine!");
   assert(mod && "Should have exited after outputting help!");
-  TargetMachine &Target = *target.get();
+  TargetMachine &Target = *TM;
 
   if (DisableDotLoc)
     Target.setMCUseLoc(false);
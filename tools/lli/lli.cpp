@@ -20,6 +20,7 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/CodeGen/LinkAllCodegenComponents.h"
+#include "llvm/ExecutionEngine/FileObjectCache.h"
 #include "llvm/ExecutionEngine/GenericValue.h"
 #include "llvm/ExecutionEngine/Interpreter.h"
 #include "llvm/ExecutionEngine/JIT.h"
@@ -122,6 +123,22 @@ namespace {
   DisableCoreFiles("disable-core-files", cl::Hidden,
                    cl::desc("Disable emission of core files if possible"));
 
+  cl::opt<std::string>
+  ObjectCacheDir("object-cache-dir",
+                 cl::desc("Cache MCJIT compiled objects in this directory"),
+                 cl::value_desc("directory"));
+
+  cl::opt<unsigned>
+  ObjectCacheMaxSize("object-cache-max-size",
+                     cl::desc("Maximum size of the object cache in megabytes "
+                              "(0 = unbounded)"),
+                     cl::init(0));
+
+  cl::opt<bool>
+  UseLinearScan("use-linear-scan",
+                cl::desc("Use the linear scan register allocator at -O1"),
+                cl::init(false));
+
   cl::opt<bool>
   NoLazyCompilation("disable-lazy-compilation",
                   cl::desc("Disable JIT lazy compilation"),
@@ -200,11 +217,13 @@ namespace {
 }
 
 static ExecutionEngine *EE = 0;
+static ObjectCache *ObjCache = 0;
 
 static void do_shutdown() {
   // Cygwin-1.5 invokes DLL's dtors before atexit handler.
 #ifndef DO_NOTHING_ATEXIT
   delete EE;
+  delete ObjCache;
   llvm_shutdown();
 #endif
 }
@@ -378,6 +397,7 @@ int main(int argc, char **argv, char * const *envp) {
     Options.FloatABIType = FloatABIForCalls;
   if (GenerateSoftFloatCalls)
     FloatABIForCalls = FloatABI::Soft;
+  Options.UseLinearScanRegAlloc = UseLinearScan;
 
   // Remote target execution doesn't handle EH or debug registration.
   if (!RemoteMCJIT) {
@@ -397,6 +417,21 @@ int main(int argc, char **argv, char * const *envp) {
     exit(1);
   }
 
+  if (!ObjectCacheDir.empty()) {
+    if (!UseMCJIT || RemoteMCJIT) {
+      errs() << argv[0] << ": -object-cache-dir requires local -use-mcjit\n";
+      exit(1);
+    }
+    std::string Features;
+    for (unsigned i = 0; i != MAttrs.size(); ++i) {
+      if (i) Features += ',';
+      Features += MAttrs[i];
+    }
+    ObjCache = new FileObjectCache(ObjectCacheDir, MCPU, Features, OLvl,
+                                   uint64_t(ObjectCacheMaxSize) << 20);
+    EE->setObjectCache(ObjCache);
+  }
+
   // The following functions have no effect if their respective profiling
   // support wasn't enabled in the build configuration.
   EE->RegisterJITEventListener(
@@ -0,0 +1,108 @@
+//===-- llvm-lto.cpp - Test driver for libLTO -----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program drives libLTO through its C interface the way a linker would:
+// it merges the given bitcode files, optimizes them and writes the resulting
+// object files.  It is used to test libLTO.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm-c/lto.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+#include <vector>
+using namespace llvm;
+
+static cl::list<std::string>
+InputFilenames(cl::Positional, cl::OneOrMore, cl::desc("<input bitcode files>"));
+
+static cl::opt<std::string>
+OutputFilename("o", cl::Required, cl::value_desc("filename"),
+  cl::desc("Output object file.  With several partitions, partition N is "
+           "written to <filename>.N"));
+
+static cl::opt<unsigned>
+Partitions("partitions", cl::init(1), cl::value_desc("N"),
+  cl::desc("Split code generation into N partitions"));
+
+static cl::list<std::string>
+ExportedSymbols("exported-symbol", cl::value_desc("symbol"),
+  cl::desc("Symbol that must be preserved"));
+
+static int error(const Twine &Msg) {
+  errs() << "llvm-lto: " << Msg << '\n';
+  return 1;
+}
+
+/// Move the temporary object file Src to Dest.  The temporary directory may
+/// be on another file system, so this copies rather than renames.
+static error_code moveObjectFile(const char *Src, const std::string &Dest) {
+  if (error_code EC =
+        sys::fs::copy_file(Src, Dest, sys::fs::copy_option::overwrite_if_exists))
+    return EC;
+  bool Existed;
+  return sys::fs::remove(Src, Existed);
+}
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  sys::PrintStackTraceOnErrorSignal();
+  PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj Y;  // Call llvm_shutdown() on exit.
+
+  cl::ParseCommandLineOptions(argc, argv, "llvm LTO test driver\n");
+
+  lto_code_gen_t CG = lto_codegen_create();
+  std::vector<lto_module_t> Modules;
+  int Ret = 0;
+
+  for (unsigned i = 0, e = InputFilenames.size(); i != e && !Ret; ++i) {
+    lto_module_t M = lto_module_create(InputFilenames[i].c_str());
+    if (!M) {
+      Ret = error("error loading file '" + InputFilenames[i] + "': " +
+                  lto_get_error_message());
+      break;
+    }
+    Modules.push_back(M);
+    if (lto_codegen_add_module(CG, M))
+      Ret = error("error adding file '" + InputFilenames[i] + "': " +
+                  lto_get_error_message());
+  }
+
+  for (unsigned i = 0, e = ExportedSymbols.size(); i != e; ++i)
+    lto_codegen_add_must_preserve_symbol(CG, ExportedSymbols[i].c_str());
+
+  const char **Names = 0;
+  unsigned Count = 0;
+  if (!Ret) {
+    lto_codegen_set_partitions(CG, Partitions);
+    if (lto_codegen_compile_partitions_to_files(CG, &Names, &Count))
+      Ret = error(Twine("error compiling the code: ") +
+                  lto_get_error_message());
+  }
+
+  for (unsigned i = 0; i != Count && !Ret; ++i) {
+    std::string Dest = OutputFilename;
+    if (Count > 1)
+      Dest += "." + Twine(i).str();
+    if (error_code EC = moveObjectFile(Names[i], Dest))
+      Ret = error("error writing '" + Dest + "': " + EC.message());
+  }
+
+  lto_codegen_dispose(CG);
+  for (unsigned i = 0, e = Modules.size(); i != e; ++i)
+    lto_module_dispose(Modules[i]);
+  return Ret;
+}
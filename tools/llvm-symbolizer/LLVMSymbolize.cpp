@@ -17,6 +17,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Path.h"
 
+#include <algorithm>
 #include <sstream>
 
 namespace llvm {
@@ -45,8 +46,16 @@ static void patchFunctionNameInDILineInfo(const std::string &NewFunctionName,
                         LineInfo.getLine(), LineInfo.getColumn());
 }
 
-ModuleInfo::ModuleInfo(ObjectFile *Obj, DIContext *DICtx)
-    : Module(Obj), DebugInfoContext(DICtx) {
+namespace {
+struct SameAddress {
+  template <typename T> bool operator()(const T &LHS, const T &RHS) const {
+    return LHS.Addr == RHS.Addr;
+  }
+};
+}
+
+ModuleInfo::ModuleInfo(ObjectFile *Obj, ObjectFile *DbgObj, DIContext *DICtx)
+    : Module(Obj), DebugModule(DbgObj), DebugInfoContext(DICtx) {
   error_code ec;
   for (symbol_iterator si = Module->begin_symbols(), se = Module->end_symbols();
        si != se; si.increment(ec)) {
@@ -68,30 +77,59 @@ ModuleInfo::ModuleInfo(ObjectFile *Obj, DIContext *DICtx)
     StringRef SymbolName;
     if (error(si->getName(SymbolName)))
       continue;
+    // Skip empty symbols, they can never contain an address.
+    if (SymbolSize == 0)
+      continue;
     // FIXME: If a function has alias, there are two entries in symbol table
     // with same address size. Make sure we choose the correct one.
-    SymbolMapTy &M = SymbolType == SymbolRef::ST_Function ? Functions : Objects;
-    SymbolDesc SD = { SymbolAddress, SymbolAddress + SymbolSize };
-    M.insert(std::make_pair(SD, SymbolName));
+    SymbolVectorTy &V = SymbolType == SymbolRef::ST_Function ? Functions
+                                                             : Objects;
+    SymbolDesc SD = { SymbolAddress, SymbolAddress + SymbolSize, SymbolName };
+    V.push_back(SD);
   }
+  sortSymbols(Functions);
+  sortSymbols(Objects);
+}
+
+void ModuleInfo::sortSymbols(SymbolVectorTy &Symbols) {
+  std::stable_sort(Symbols.begin(), Symbols.end());
+  SymbolVectorTy::iterator NewEnd =
+      std::unique(Symbols.begin(), Symbols.end(), SameAddress());
+  Symbols.erase(NewEnd, Symbols.end());
+  SymbolVectorTy(Symbols).swap(Symbols);
 }
 
 bool ModuleInfo::getNameFromSymbolTable(SymbolRef::Type Type, uint64_t Address,
                                         std::string &Name, uint64_t &Addr,
                                         uint64_t &Size) const {
-  const SymbolMapTy &M = Type == SymbolRef::ST_Function ? Functions : Objects;
-  SymbolDesc SD = { Address, Address + 1 };
-  SymbolMapTy::const_iterator it = M.find(SD);
-  if (it == M.end())
+  const SymbolVectorTy &V = Type == SymbolRef::ST_Function ? Functions
+                                                           : Objects;
+  // Find the last symbol starting at or before Address.
+  SymbolDesc SD = { Address, Address + 1, StringRef() };
+  SymbolVectorTy::const_iterator it =
+      std::upper_bound(V.begin(), V.end(), SD);
+  if (it == V.begin())
     return false;
-  if (Address < it->first.Addr || Address >= it->first.AddrEnd)
+  --it;
+  if (Address >= it->AddrEnd)
     return false;
-  Name = it->second.str();
-  Addr = it->first.Addr;
-  Size = it->first.AddrEnd - it->first.Addr;
+  Name = it->Name.str();
+  Addr = it->Addr;
+  Size = it->AddrEnd - it->Addr;
   return true;
 }
 
+uint64_t ModuleInfo::getMemorySize() const {
+  uint64_t Size = sizeof(*this) +
+                  (Functions.capacity() + Objects.capacity()) *
+                      sizeof(SymbolDesc);
+  if (Module)
+    Size += Module->getData().size();
+  if (DebugModule)
+    Size += DebugModule->getData().size();
+  return Size;
+}
+
 DILineInfo ModuleInfo::symbolizeCode(
     uint64_t ModuleOffset, const LLVMSymbolizer::Options &Opts) const {
   DILineInfo LineInfo;
@@ -188,7 +226,31 @@ std::string LLVMSymbolizer::symbolizeData(const std::string &ModuleName,
 }
 
 void LLVMSymbolizer::flush() {
-  DeleteContainerSeconds(Modules);
+  for (ModuleMapTy::iterator I = Modules.begin(), E = Modules.end(); I != E;
+       ++I)
+    delete I->second.Info;
+  Modules.clear();
+  CacheSize = 0;
+}
+
+void LLVMSymbolizer::pruneModules(const ModuleInfo *Keep) {
+  while (Opts.MaxCacheSize != 0 && CacheSize > Opts.MaxCacheSize) {
+    ModuleMapTy::iterator Victim = Modules.end();
+    for (ModuleMapTy::iterator I = Modules.begin(), E = Modules.end(); I != E;
+         ++I) {
+      if (I->second.Info == 0 || I->second.Info == Keep)
+        continue;
+      if (Victim == Modules.end() ||
+          I->second.LastUse < Victim->second.LastUse)
+        Victim = I;
+    }
+    if (Victim == Modules.end())
+      return;
+    CacheSize -= Victim->second.Info->getMemorySize();
+    delete Victim->second.Info;
+    Modules.erase(Victim);
+    ++NumModulesEvicted;
+  }
 }
 
 // Returns true if the object endianness is known.
@@ -217,22 +279,26 @@ static std::string getDarwinDWARFResourceForModule(const std::string &Path) {
 ModuleInfo *
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   ModuleMapTy::iterator I = Modules.find(ModuleName);
-  if (I != Modules.end())
-    return I->second;
+  if (I != Modules.end()) {
+    I->second.LastUse = ++UseCounter;
+    return I->second.Info;
+  }
 
+  ModuleEntry Entry = { 0, ++UseCounter };
   ObjectFile *Obj = getObjectFile(ModuleName);
   if (Obj == 0) {
     // Module name doesn't point to a valid object file.
-    Modules.insert(make_pair(ModuleName, (ModuleInfo *)0));
+    Modules.insert(make_pair(ModuleName, Entry));
     return 0;
   }
 
   DIContext *Context = 0;
+  ObjectFile *DbgObj = 0;
   bool IsLittleEndian;
   if (getObjectEndianness(Obj, IsLittleEndian)) {
     // On Darwin we may find DWARF in separate object file in
     // resource directory.
-    ObjectFile *DbgObj = Obj;
+    DbgObj = Obj;
     if (isa<MachOObjectFile>(Obj)) {
       const std::string &ResourceName =
           getDarwinDWARFResourceForModule(ModuleName);
@@ -244,8 +310,14 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
     assert(Context);
   }
 
-  ModuleInfo *Info = new ModuleInfo(Obj, Context);
-  Modules.insert(make_pair(ModuleName, Info));
+  if (DbgObj == Obj)
+    DbgObj = 0;
+  ModuleInfo *Info = new ModuleInfo(Obj, DbgObj, Context);
+  Entry.Info = Info;
+  Modules.insert(make_pair(ModuleName, Entry));
+  ++NumModulesLoaded;
+  CacheSize += Info->getMemorySize();
+  pruneModules(Info);
   return Info;
 }
 
@@ -19,6 +19,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include <map>
 #include <string>
+#include <vector>
 
 namespace llvm {
 
@@ -35,14 +36,22 @@ public:
     bool PrintFunctions : 1;
     bool PrintInlining : 1;
     bool Demangle : 1;
+    // If non-zero, the least recently used modules are unloaded once the
+    // loaded modules take up more than this many bytes.
+    uint64_t MaxCacheSize;
     Options(bool UseSymbolTable = true, bool PrintFunctions = true,
-            bool PrintInlining = true, bool Demangle = true)
+            bool PrintInlining = true, bool Demangle = true,
+            uint64_t MaxCacheSize = 0)
         : UseSymbolTable(UseSymbolTable), PrintFunctions(PrintFunctions),
-          PrintInlining(PrintInlining), Demangle(Demangle) {
+          PrintInlining(PrintInlining), Demangle(Demangle),
+          MaxCacheSize(MaxCacheSize) {
     }
   };
 
-  LLVMSymbolizer(const Options &Opts = Options()) : Opts(Opts) {}
+  LLVMSymbolizer(const Options &Opts = Options())
+      : Opts(Opts), CacheSize(0), UseCounter(0), NumModulesLoaded(0),
+        NumModulesEvicted(0) {}
+  ~LLVMSymbolizer() { flush(); }
 
   // Returns the result of symbolization for module name/offset as
   // a string (possibly containing newlines).
@@ -51,20 +60,36 @@ public:
   std::string
   symbolizeData(const std::string &ModuleName, uint64_t ModuleOffset);
   void flush();
+
+  unsigned getNumModulesLoaded() const { return NumModulesLoaded; }
+  unsigned getNumModulesEvicted() const { return NumModulesEvicted; }
 private:
   ModuleInfo *getOrCreateModuleInfo(const std::string &ModuleName);
+  // Unloads the least recently used modules, other than Keep, until the
+  // loaded modules fit in Opts.MaxCacheSize.
+  void pruneModules(const ModuleInfo *Keep);
   std::string printDILineInfo(DILineInfo LineInfo) const;
   void DemangleName(std::string &Name) const;
 
-  typedef std::map<std::string, ModuleInfo *> ModuleMapTy;
+  struct ModuleEntry {
+    ModuleInfo *Info;
+    uint64_t LastUse;
+  };
+  typedef std::map<std::string, ModuleEntry> ModuleMapTy;
   ModuleMapTy Modules;
   Options Opts;
+  uint64_t CacheSize;
+  uint64_t UseCounter;
+  unsigned NumModulesLoaded;
+  unsigned NumModulesEvicted;
   static const char kBadString[];
 };
 
 class ModuleInfo {
 public:
-  ModuleInfo(ObjectFile *Obj, DIContext *DICtx);
+  // DbgObj is the object holding the debug info, if it differs from Obj.
+  // ModuleInfo takes ownership of all of its arguments.
+  ModuleInfo(ObjectFile *Obj, ObjectFile *DbgObj, DIContext *DICtx);
 
   DILineInfo symbolizeCode(uint64_t ModuleOffset,
                            const LLVMSymbolizer::Options &Opts) const;
@@ -73,23 +98,34 @@ public:
   bool symbolizeData(uint64_t ModuleOffset, std::string &Name, uint64_t &Start,
                      uint64_t &Size) const;
 
+  // Returns the approximate number of bytes of memory held by the module:
+  // the object files and the symbol tables. Memory used by the parsed debug
+  // info is not included.
+  uint64_t getMemorySize() const;
+
 private:
   bool getNameFromSymbolTable(SymbolRef::Type Type, uint64_t Address,
                               std::string &Name, uint64_t &Addr,
                               uint64_t &Size) const;
   OwningPtr<ObjectFile> Module;
+  OwningPtr<ObjectFile> DebugModule;
   OwningPtr<DIContext> DebugInfoContext;
 
   struct SymbolDesc {
     uint64_t Addr;
     uint64_t AddrEnd;
+    StringRef Name;
     friend bool operator<(const SymbolDesc &s1, const SymbolDesc &s2) {
-      return s1.AddrEnd <= s2.Addr;
+      return s1.Addr < s2.Addr;
     }
   };
-  typedef std::map<SymbolDesc, StringRef> SymbolMapTy;
-  SymbolMapTy Functions;
-  SymbolMapTy Objects;
+  // Symbols sorted by start address, searched with binary search. Of the
+  // symbols starting at the same address, only the first one in the symbol
+  // table is kept.
+  typedef std::vector<SymbolDesc> SymbolVectorTy;
+  static void sortSymbols(SymbolVectorTy &Symbols);
+  SymbolVectorTy Functions;
+  SymbolVectorTy Objects;
 };
 
 } // namespace symbolize
@@ -19,13 +19,17 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
 
 using namespace llvm;
 using namespace symbolize;
@@ -47,19 +51,31 @@ ClPrintInlining("inlining", cl::init(true),
 static cl::opt<bool>
 ClDemangle("demangle", cl::init(true), cl::desc("Demangle function names"));
 
-static bool parseCommand(bool &IsData, std::string &ModuleName,
-                         uint64_t &ModuleOffset) {
+static cl::opt<unsigned>
+ClCacheSize("cache-size", cl::init(0),
+            cl::desc("Unload the least recently used modules once the "
+                     "loaded modules take up more than this many "
+                     "kilobytes (0 = unbounded)"));
+
+static cl::opt<std::string>
+ClReplay("replay", cl::init(""), cl::value_desc("filename"),
+         cl::desc("Read requests from a file, discard the results and "
+                  "print timing and cache statistics"));
+
+// Parses a request of the form "[CODE|DATA] module offset [offset...]".
+// Several offsets into the same module may be given on one line.
+static bool parseCommand(FILE *Input, bool &IsData, std::string &ModuleName,
+                         std::vector<uint64_t> &ModuleOffsets) {
   const char *kDataCmd = "DATA ";
   const char *kCodeCmd = "CODE ";
-  const int kMaxInputStringLength = 1024;
   const char kDelimiters[] = " \n";
-  char InputString[kMaxInputStringLength];
-  if (!fgets(InputString, sizeof(InputString), stdin))
+  std::string InputString;
+  if (!ReadLine(Input, InputString))
     return false;
   IsData = false;
   ModuleName = "";
-  std::string ModuleOffsetStr = "";
-  char *pos = InputString;
+  ModuleOffsets.clear();
+  const char *pos = InputString.c_str();
   if (strncmp(pos, kDataCmd, strlen(kDataCmd)) == 0) {
     IsData = true;
     pos += strlen(kDataCmd);
@@ -75,7 +91,7 @@ static bool parseCommand(bool &IsData, std::string &ModuleName,
   if (*pos == '"' || *pos == '\'') {
     char quote = *pos;
     pos++;
-    char *end = strchr(pos, quote);
+    const char *end = strchr(pos, quote);
     if (end == 0)
       return false;
     ModuleName = std::string(pos, end - pos);
@@ -85,12 +101,17 @@ static bool parseCommand(bool &IsData, std::string &ModuleName,
     ModuleName = std::string(pos, name_length);
     pos += name_length;
   }
-  // Skip delimiters and parse module offset.
+  // Skip delimiters and parse module offsets.
   pos += strspn(pos, kDelimiters);
-  int offset_length = strcspn(pos, kDelimiters);
-  ModuleOffsetStr = std::string(pos, offset_length);
-  if (StringRef(ModuleOffsetStr).getAsInteger(0, ModuleOffset))
-    return false;
+  do {
+    int offset_length = strcspn(pos, kDelimiters);
+    uint64_t ModuleOffset;
+    if (StringRef(pos, offset_length).getAsInteger(0, ModuleOffset))
+      return false;
+    ModuleOffsets.push_back(ModuleOffset);
+    pos += offset_length;
+    pos += strspn(pos, kDelimiters);
+  } while (*pos);
   return true;
 }
 
@@ -102,18 +123,52 @@ int main(int argc, char **argv) {
 
   cl::ParseCommandLineOptions(argc, argv, "llvm symbolizer for compiler-rt\n");
   LLVMSymbolizer::Options Opts(ClUseSymbolTable, ClPrintFunctions,
-                               ClPrintInlining, ClDemangle);
+                               ClPrintInlining, ClDemangle,
+                               (uint64_t)ClCacheSize << 10);
   LLVMSymbolizer Symbolizer(Opts);
 
+  FILE *Input = stdin;
+  bool Replay = !ClReplay.empty();
+  if (Replay) {
+    Input = fopen(ClReplay.c_str(), "r");
+    if (!Input) {
+      errs() << argv[0] << ": cannot open '" << ClReplay << "'\n";
+      return 1;
+    }
+  }
+
+  TimeRecord StartTime = TimeRecord::getCurrentTime();
+  unsigned NumRequests = 0, NumAddresses = 0;
   bool IsData = false;
   std::string ModuleName;
-  uint64_t ModuleOffset;
-  while (parseCommand(IsData, ModuleName, ModuleOffset)) {
-    std::string Result =
-        IsData ? Symbolizer.symbolizeData(ModuleName, ModuleOffset)
-               : Symbolizer.symbolizeCode(ModuleName, ModuleOffset);
-    outs() << Result << "\n";
-    outs().flush();
+  std::vector<uint64_t> ModuleOffsets;
+  while (parseCommand(Input, IsData, ModuleName, ModuleOffsets)) {
+    ++NumRequests;
+    for (unsigned i = 0, e = ModuleOffsets.size(); i != e; ++i) {
+      std::string Result =
+          IsData ? Symbolizer.symbolizeData(ModuleName, ModuleOffsets[i])
+                 : Symbolizer.symbolizeCode(ModuleName, ModuleOffsets[i]);
+      ++NumAddresses;
+      if (!Replay)
+        outs() << Result << "\n";
+    }
+    if (!Replay)
+      outs().flush();
+  }
+
+  if (Replay) {
+    fclose(Input);
+    TimeRecord Elapsed = TimeRecord::getCurrentTime(false);
+    Elapsed -= StartTime;
+    double Seconds = Elapsed.getWallTime();
+    errs() << "requests:        " << NumRequests << "\n"
+           << "addresses:       " << NumAddresses << "\n"
+           << "modules loaded:  " << Symbolizer.getNumModulesLoaded() << "\n"
+           << "modules evicted: " << Symbolizer.getNumModulesEvicted() << "\n"
+           << "wall time:       " << format("%.3f", Seconds) << "s\n";
+    if (Seconds > 0)
+      errs() << "addresses/s:     "
+             << format("%.1f", NumAddresses / Seconds) << "\n";
   }
   return 0;
 }
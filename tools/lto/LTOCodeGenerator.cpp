@@ -14,6 +14,8 @@
 
 #include "LTOCodeGenerator.h"
 #include "LTOModule.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/Passes.h"
 #include "llvm/Analysis/Verifier.h"
@@ -29,13 +31,16 @@
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/PassManager.h"
+#include "llvm/Support/CallSite.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/InstIterator.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/system_error.h"
 #include "llvm/Target/Mangler.h"
@@ -72,7 +77,7 @@ LTOCodeGenerator::LTOCodeGenerator()
     _linker("LinkTimeOptimizer", "ld-temp.o", _context), _target(NULL),
     _emitDwarfDebugInfo(false), _scopeRestrictionsDone(false),
     _codeModel(LTO_CODEGEN_PIC_MODEL_DYNAMIC),
-    _nativeObjectFile(NULL) {
+    _nativeObjectFile(NULL), _partitions(1) {
   InitializeAllTargets();
   InitializeAllTargetMCs();
   InitializeAllAsmPrinters();
@@ -156,14 +161,24 @@ bool LTOCodeGenerator::writeMergedModules(const char *path,
   return false;
 }
 
-bool LTOCodeGenerator::compile_to_file(const char** name, std::string& errMsg) {
-  // make unique temp .o file to put generated object file
+bool LTOCodeGenerator::createTemporaryObjectFile(std::string &path,
+                                                 std::string &errMsg) {
   sys::PathWithStatus uniqueObjPath("lto-llvm.o");
   if (uniqueObjPath.createTemporaryFileOnDisk(false, &errMsg)) {
     uniqueObjPath.eraseFromDisk();
     return true;
   }
   sys::RemoveFileOnSignal(uniqueObjPath);
+  path = uniqueObjPath.str();
+  return false;
+}
+
+bool LTOCodeGenerator::compile_to_file(const char** name, std::string& errMsg) {
+  // make unique temp .o file to put generated object file
+  std::string objPath;
+  if (createTemporaryObjectFile(objPath, errMsg))
+    return true;
+  sys::Path uniqueObjPath(objPath);
 
   // generate object file
   bool genResult = false;
@@ -352,9 +367,34 @@ void LTOCodeGenerator::applyScopeRestrictions() {
   _scopeRestrictionsDone = true;
 }
 
+/// Run the code generator for the given module, writing an object file to out.
+static bool emitObjectFile(Module &M, TargetMachine &target, raw_ostream &out,
+                           std::string &errMsg) {
+  PassManager codeGenPasses;
+
+  codeGenPasses.add(new DataLayout(*target.getDataLayout()));
+  target.addAnalysisPasses(codeGenPasses);
+
+  formatted_raw_ostream Out(out);
+
+  // If the bitcode files contain ARC code and were compiled with optimization,
+  // the ObjCARCContractPass must be run, so do it unconditionally here.
+  codeGenPasses.add(createObjCARCContractPass());
+
+  if (target.addPassesToEmitFile(codeGenPasses, Out,
+                                 TargetMachine::CGFT_ObjectFile)) {
+    errMsg = "target file type not supported";
+    return true;
+  }
+
+  // Run the code generator, and write assembly file
+  codeGenPasses.run(M);
+
+  return false; // success
+}
+
 /// Optimize merged modules using various IPO passes
-bool LTOCodeGenerator::generateObjectFile(raw_ostream &out,
-                                          std::string &errMsg) {
+bool LTOCodeGenerator::optimizeMergedModule(std::string &errMsg) {
   if (this->determineTarget(errMsg))
     return true;
 
@@ -391,30 +431,526 @@ bool LTOCodeGenerator::generateObjectFile(raw_ostream &out,
   // Make sure everything is still good.
   passes.add(createVerifierPass());
 
-  PassManager codeGenPasses;
+  // Run our queue of passes all at once now, efficiently.
+  passes.run(*mergedModule);
 
-  codeGenPasses.add(new DataLayout(*_target->getDataLayout()));
-  _target->addAnalysisPasses(codeGenPasses);
+  return false;
+}
 
-  formatted_raw_ostream Out(out);
+bool LTOCodeGenerator::generateObjectFile(raw_ostream &out,
+                                          std::string &errMsg) {
+  if (optimizeMergedModule(errMsg))
+    return true;
 
-  // If the bitcode files contain ARC code and were compiled with optimization,
-  // the ObjCARCContractPass must be run, so do it unconditionally here.
-  codeGenPasses.add(createObjCARCContractPass());
+  return emitObjectFile(*_linker.getModule(), *_target, out, errMsg);
+}
 
-  if (_target->addPassesToEmitFile(codeGenPasses, Out,
-                                   TargetMachine::CGFT_ObjectFile)) {
-    errMsg = "target file type not supported";
+//===----------------------------------------------------------------------===//
+// Partitioned code generation
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// ModulePartitioning - The codegen partition of every global definition in
+/// a module. The assignments are recorded in module order so that they can be
+/// applied to copies of the module read back from bitcode in other contexts.
+struct ModulePartitioning {
+  std::vector<unsigned> Functions;
+  std::vector<unsigned> Variables;
+  std::vector<unsigned> Aliases;
+};
+
+typedef DenseMap<const GlobalValue*, unsigned> PartitionMap;
+
+/// PartitionJob - The state of one partition's code generator thread.
+struct PartitionJob {
+  StringRef Bitcode;
+  StringRef ModuleID;
+  const ModulePartitioning *Partitioning;
+  unsigned Partition;
+  TargetMachine *Target;
+  std::string ObjPath;
+  std::string ErrMsg;
+  bool Failed;
+};
+
+} // end anonymous namespace
+
+/// Assign the global variables that C refers to, directly or through their
+/// initializers, to the given partition unless they are already placed.
+static void assignReferencedVariables(Constant *C, unsigned part,
+                                      PartitionMap &parts,
+                                      SmallPtrSet<Constant*, 32> &visited) {
+  SmallVector<Constant*, 16> worklist;
+  worklist.push_back(C);
+  while (!worklist.empty()) {
+    Constant *cur = worklist.pop_back_val();
+    if (!visited.insert(cur))
+      continue;
+    if (GlobalVariable *GV = dyn_cast<GlobalVariable>(cur)) {
+      if (GV->isDeclaration() || parts.count(GV))
+        continue;
+      parts[GV] = part;
+      worklist.push_back(GV->getInitializer());
+      continue;
+    }
+    if (isa<GlobalValue>(cur))
+      continue;
+    for (User::op_iterator i = cur->op_begin(), e = cur->op_end(); i != e; ++i)
+      if (Constant *op = dyn_cast<Constant>(*i))
+        worklist.push_back(op);
+  }
+}
+
+/// Determine which partitions refer to gv, looking through constants. Returns
+/// true if gv is used from a partition other than its own. Sets unsplittable
+/// if a blockaddress of gv escapes its partition, which cannot be expressed
+/// once the function body lives in another module.
+static bool isUsedOutsidePartition(GlobalValue *GV, const PartitionMap &parts,
+                                   bool &unsplittable) {
+  unsigned part = parts.lookup(GV);
+  bool usedOutside = false;
+
+  SmallVector<std::pair<User*, bool>, 16> worklist;
+  for (Value::use_iterator i = GV->use_begin(), e = GV->use_end(); i != e; ++i)
+    worklist.push_back(std::make_pair(*i, false));
+
+  while (!worklist.empty()) {
+    User *U = worklist.back().first;
+    bool viaBlockAddress = worklist.back().second;
+    worklist.pop_back();
+
+    const GlobalValue *owner = 0;
+    if (Instruction *I = dyn_cast<Instruction>(U))
+      owner = I->getParent()->getParent();
+    else if (GlobalValue *UGV = dyn_cast<GlobalValue>(U))
+      owner = UGV;
+    else {
+      viaBlockAddress |= isa<BlockAddress>(U);
+      for (Value::use_iterator i = U->use_begin(), e = U->use_end(); i != e;
+           ++i)
+        worklist.push_back(std::make_pair(*i, viaBlockAddress));
+      continue;
+    }
+
+    if (parts.lookup(owner) != part) {
+      usedOutside = true;
+      if (viaBlockAddress)
+        unsplittable = true;
+    }
+  }
+  return usedOutside;
+}
+
+/// Returns true if C, which is used from partition part, takes the address of
+/// a block in another partition.  The function is found through the block,
+/// because the linker can leave a blockaddress naming the source module's
+/// copy of the function.  Such a blockaddress cannot be written to bitcode
+/// for the partitions either, so it also counts.
+static bool hasBlockAddressOutside(Constant *C, unsigned part,
+                                   const PartitionMap &parts,
+                                   SmallPtrSet<Constant*, 32> &visited) {
+  SmallVector<Constant*, 16> worklist;
+  worklist.push_back(C);
+  while (!worklist.empty()) {
+    Constant *cur = worklist.pop_back_val();
+    if (isa<GlobalValue>(cur) || !visited.insert(cur))
+      continue;
+    if (BlockAddress *BA = dyn_cast<BlockAddress>(cur)) {
+      Function *owner = BA->getBasicBlock()->getParent();
+      if (BA->getFunction() != owner || parts.lookup(owner) != part)
+        return true;
+      continue;
+    }
+    for (User::op_iterator i = cur->op_begin(), e = cur->op_end(); i != e; ++i)
+      if (Constant *op = dyn_cast<Constant>(*i))
+        worklist.push_back(op);
+  }
+  return false;
+}
+
+/// Split mergedModule into numParts partitions for code generation.
+///
+/// Functions are laid out in depth-first order over direct calls so that
+/// callers and callees tend to land in the same partition, and then cut into
+/// pieces of roughly equal instruction count. Global variables follow the
+/// first function that refers to them. Local symbols that are referenced
+/// across partitions are given hidden external linkage so the partitions can
+/// be linked back together. Returns false if the module cannot be split.
+static bool partitionModule(Module &M, unsigned numParts,
+                            ModulePartitioning &result) {
+  PartitionMap parts;
+
+  // Order the function definitions by call graph affinity.
+  std::vector<Function*> order;
+  std::vector<unsigned> sizes;
+  uint64_t totalSize = 0;
+  SmallPtrSet<Function*, 64> visited;
+  for (Module::iterator f = M.begin(), e = M.end(); f != e; ++f) {
+    if (f->isDeclaration() || !visited.insert(f))
+      continue;
+    SmallVector<Function*, 16> worklist;
+    worklist.push_back(f);
+    while (!worklist.empty()) {
+      Function *F = worklist.pop_back_val();
+      unsigned size = 0;
+      for (inst_iterator i = inst_begin(F), ie = inst_end(F); i != ie; ++i) {
+        ++size;
+        CallSite CS(&*i);
+        if (!CS)
+          continue;
+        Function *callee = CS.getCalledFunction();
+        if (callee && !callee->isDeclaration() && visited.insert(callee))
+          worklist.push_back(callee);
+      }
+      order.push_back(F);
+      sizes.push_back(size);
+      totalSize += size;
+    }
+  }
+
+  // Cut the ordered functions into pieces of similar size.
+  uint64_t partSize = (totalSize + numParts - 1) / numParts;
+  unsigned part = 0;
+  uint64_t accumulated = 0;
+  for (unsigned i = 0, e = order.size(); i != e; ++i) {
+    parts[order[i]] = part;
+    accumulated += sizes[i];
+    if (accumulated >= partSize * (part + 1) && part + 1 < numParts)
+      ++part;
+  }
+
+  // Appending variables such as llvm.global_ctors must only be emitted once.
+  // llvm.used and llvm.compiler.used are cut down for every partition by
+  // extractPartition instead.
+  for (Module::global_iterator v = M.global_begin(), e = M.global_end();
+       v != e; ++v)
+    if (v->hasAppendingLinkage())
+      parts[v] = 0;
+
+  // Place global variables with their first user.
+  SmallPtrSet<Constant*, 32> visitedConstants;
+  for (unsigned i = 0, e = order.size(); i != e; ++i)
+    for (inst_iterator I = inst_begin(order[i]), IE = inst_end(order[i]);
+         I != IE; ++I)
+      for (User::op_iterator op = I->op_begin(), ope = I->op_end(); op != ope;
+           ++op)
+        if (Constant *C = dyn_cast<Constant>(*op))
+          assignReferencedVariables(C, parts[order[i]], parts,
+                                    visitedConstants);
+
+  for (Module::global_iterator v = M.global_begin(), e = M.global_end();
+       v != e; ++v)
+    if (!v->isDeclaration() && !parts.count(v))
+      parts[v] = 0;
+
+  // Aliases go with the global they resolve to.
+  for (Module::alias_iterator a = M.alias_begin(), e = M.alias_end(); a != e;
+       ++a) {
+    const GlobalValue *base = a->resolveAliasedGlobal(false);
+    parts[a] = base ? parts.lookup(base) : 0;
+  }
+
+  // Find the local symbols that have to be visible to other partitions.
+  std::vector<GlobalValue*> promote;
+  bool unsplittable = false;
+  for (Module::iterator f = M.begin(), e = M.end(); f != e; ++f)
+    if (!f->isDeclaration() &&
+        isUsedOutsidePartition(f, parts, unsplittable) && f->hasLocalLinkage())
+      promote.push_back(f);
+  for (Module::global_iterator v = M.global_begin(), e = M.global_end();
+       v != e; ++v)
+    if (!v->isDeclaration() && v->hasLocalLinkage() &&
+        isUsedOutsidePartition(v, parts, unsplittable))
+      promote.push_back(v);
+  for (Module::alias_iterator a = M.alias_begin(), e = M.alias_end(); a != e;
+       ++a)
+    if (a->hasLocalLinkage() && isUsedOutsidePartition(a, parts, unsplittable))
+      promote.push_back(a);
+
+  // Look for block addresses directly as well, see hasBlockAddressOutside.
+  for (Module::iterator f = M.begin(), e = M.end(); f != e && !unsplittable;
+       ++f) {
+    SmallPtrSet<Constant*, 32> visitedConstants;
+    unsigned part = parts.lookup(f);
+    for (inst_iterator I = inst_begin(f), IE = inst_end(f);
+         I != IE && !unsplittable; ++I)
+      for (User::op_iterator op = I->op_begin(), ope = I->op_end(); op != ope;
+           ++op)
+        if (Constant *C = dyn_cast<Constant>(*op))
+          if (hasBlockAddressOutside(C, part, parts, visitedConstants)) {
+            unsplittable = true;
+            break;
+          }
+  }
+  for (Module::global_iterator v = M.global_begin(), e = M.global_end();
+       v != e && !unsplittable; ++v) {
+    SmallPtrSet<Constant*, 32> visitedConstants;
+    if (v->hasInitializer() &&
+        hasBlockAddressOutside(v->getInitializer(), parts.lookup(v), parts,
+                               visitedConstants))
+      unsplittable = true;
+  }
+
+  if (unsplittable)
+    return false;
+
+  for (unsigned i = 0, e = promote.size(); i != e; ++i) {
+    GlobalValue *GV = promote[i];
+    if (GV->hasName())
+      GV->setName(GV->getName() + ".llvm_lto");
+    else
+      GV->setName("__llvm_lto_anon");
+    GV->setLinkage(GlobalValue::ExternalLinkage);
+    GV->setVisibility(GlobalValue::HiddenVisibility);
+  }
+
+  for (Module::iterator f = M.begin(), e = M.end(); f != e; ++f)
+    result.Functions.push_back(parts.lookup(f));
+  for (Module::global_iterator v = M.global_begin(), e = M.global_end();
+       v != e; ++v)
+    result.Variables.push_back(parts.lookup(v));
+  for (Module::alias_iterator a = M.alias_begin(), e = M.alias_end(); a != e;
+       ++a)
+    result.Aliases.push_back(parts.lookup(a));
+  return true;
+}
+
+/// Returns true if GV is one of the lists of globals that must be kept even
+/// when nothing refers to them.
+static bool isUsedList(const GlobalVariable *GV) {
+  return GV->getName() == "llvm.used" || GV->getName() == "llvm.compiler.used";
+}
+
+/// Rebuild the used list GV with only the globals that are still defined in
+/// this module, so that each partition marks its own definitions.
+static void restrictUsedList(GlobalVariable *GV) {
+  ConstantArray *init = dyn_cast_or_null<ConstantArray>(GV->getInitializer());
+  if (!init)
+    return;
+
+  std::vector<Constant*> kept;
+  for (unsigned i = 0, e = init->getNumOperands(); i != e; ++i) {
+    Constant *C = init->getOperand(i);
+    GlobalValue *G = dyn_cast<GlobalValue>(C->stripPointerCasts());
+    if (G && !G->isDeclaration())
+      kept.push_back(C);
+  }
+  if (kept.size() == init->getNumOperands())
+    return;
+  if (kept.empty()) {
+    GV->eraseFromParent();
+    return;
+  }
+
+  ArrayType *ty = ArrayType::get(init->getType()->getElementType(),
+                                 kept.size());
+  GlobalVariable *newGV =
+    new GlobalVariable(*GV->getParent(), ty, false, GV->getLinkage(),
+                       ConstantArray::get(ty, kept), "", GV);
+  newGV->setSection(GV->getSection());
+  newGV->takeName(GV);
+  GV->eraseFromParent();
+}
+
+/// Turn every definition that does not belong to the given partition into a
+/// declaration.
+static void extractPartition(Module &M, const ModulePartitioning &partitioning,
+                             unsigned part) {
+  std::vector<Function*> functions;
+  for (Module::iterator f = M.begin(), e = M.end(); f != e; ++f)
+    functions.push_back(f);
+  std::vector<GlobalVariable*> variables;
+  for (Module::global_iterator v = M.global_begin(), e = M.global_end();
+       v != e; ++v)
+    variables.push_back(v);
+  std::vector<GlobalAlias*> aliases;
+  for (Module::alias_iterator a = M.alias_begin(), e = M.alias_end(); a != e;
+       ++a)
+    aliases.push_back(a);
+
+  for (unsigned i = 0, e = functions.size(); i != e; ++i)
+    if (partitioning.Functions[i] != part && !functions[i]->isDeclaration())
+      functions[i]->deleteBody();
+
+  std::vector<GlobalVariable*> usedLists;
+  for (unsigned i = 0, e = variables.size(); i != e; ++i) {
+    GlobalVariable *GV = variables[i];
+    if (isUsedList(GV)) {
+      usedLists.push_back(GV);
+      continue;
+    }
+    if (partitioning.Variables[i] == part || GV->isDeclaration())
+      continue;
+    if (GV->hasAppendingLinkage()) {
+      GV->eraseFromParent();
+      continue;
+    }
+    GV->setInitializer(0);
+    GV->setLinkage(GlobalValue::ExternalLinkage);
+  }
+
+  for (unsigned i = 0, e = aliases.size(); i != e; ++i) {
+    GlobalAlias *GA = aliases[i];
+    if (partitioning.Aliases[i] == part)
+      continue;
+    GlobalValue *decl;
+    Type *ty = GA->getType()->getElementType();
+    if (FunctionType *FTy = dyn_cast<FunctionType>(ty))
+      decl = Function::Create(FTy, GlobalValue::ExternalLinkage, "", &M);
+    else
+      decl = new GlobalVariable(M, ty, false, GlobalValue::ExternalLinkage, 0,
+                                "", 0, GlobalVariable::NotThreadLocal,
+                                GA->getType()->getAddressSpace());
+    decl->takeName(GA);
+    decl->setVisibility(GA->getVisibility());
+    GA->replaceAllUsesWith(decl);
+    GA->eraseFromParent();
+  }
+
+  for (unsigned i = 0, e = usedLists.size(); i != e; ++i)
+    restrictUsedList(usedLists[i]);
+
+  // Module level inline assembly is emitted by the first partition only.
+  if (part != 0)
+    M.setModuleInlineAsm("");
+}
+
+/// Generate an object file for M at path.
+static bool writeObjectFile(Module &M, TargetMachine &target,
+                            const std::string &path, std::string &errMsg) {
+  tool_output_file objFile(path.c_str(), errMsg);
+  if (!errMsg.empty())
+    return true;
+  if (emitObjectFile(M, target, objFile.os(), errMsg))
+    return true;
+  objFile.os().close();
+  if (objFile.os().has_error()) {
+    objFile.os().clear_error();
+    errMsg = "could not write object file: " + path;
+    return true;
+  }
+  objFile.keep();
+  return false;
+}
+
+/// Read a private copy of the optimized module, extract one partition from it
+/// and generate its object file.
+static void runPartitionJob(void *arg) {
+  PartitionJob &job = *static_cast<PartitionJob*>(arg);
+  job.Failed = true;
+
+  LLVMContext context;
+  OwningPtr<MemoryBuffer> buffer(
+    MemoryBuffer::getMemBuffer(job.Bitcode, job.ModuleID, false));
+  OwningPtr<Module> M(ParseBitcodeFile(buffer.get(), context, &job.ErrMsg));
+  if (!M)
+    return;
+
+  extractPartition(*M, *job.Partitioning, job.Partition);
+
+  job.Failed = writeObjectFile(*M, *job.Target, job.ObjPath, job.ErrMsg);
+}
+
+/// Run the jobs, concurrently if the host supports threads.
+static void runPartitionJobs(std::vector<PartitionJob> &jobs) {
+  bool startedMultithreaded = false;
+  if (!llvm_is_multithreaded())
+    startedMultithreaded = llvm_start_multithreaded();
+
+  std::vector<void*> args(jobs.size());
+  for (unsigned i = 0, e = jobs.size(); i != e; ++i)
+    args[i] = &jobs[i];
+
+  // Code generation recurses deeply, so do not rely on the default stack
+  // size for secondary threads.
+  llvm_execute_on_threads(runPartitionJob, &args[0], args.size(), 8 << 20);
+
+  if (startedMultithreaded)
+    llvm_stop_multithreaded();
+}
+
+/// compile_partitions_to_files - Optimize the merged module, split it into
+/// partitions and generate an object file for each of them in parallel.
+bool LTOCodeGenerator::compile_partitions_to_files(const char ***names,
+                                                   unsigned *count,
+                                                   std::string &errMsg) {
+  _nativeObjectPaths.clear();
+  _nativeObjectNames.clear();
+
+  if (optimizeMergedModule(errMsg))
     return true;
+
+  Module *mergedModule = _linker.getModule();
+  ModulePartitioning partitioning;
+  if (_partitions <= 1 ||
+      !partitionModule(*mergedModule, _partitions, partitioning)) {
+    std::string objPath;
+    if (createTemporaryObjectFile(objPath, errMsg))
+      return true;
+    if (writeObjectFile(*mergedModule, *_target, objPath, errMsg)) {
+      sys::Path(objPath).eraseFromDisk();
+      return true;
+    }
+    _nativeObjectPaths.push_back(objPath);
+    _nativeObjectNames.push_back(_nativeObjectPaths.back().c_str());
+    *names = &_nativeObjectNames[0];
+    *count = 1;
+    return false;
   }
 
-  // Run our queue of passes all at once now, efficiently.
-  passes.run(*mergedModule);
+  // Every partition reads its own copy of the module, so that the code
+  // generators do not share an LLVMContext.
+  SmallVector<char, 0> bitcode;
+  {
+    raw_svector_ostream OS(bitcode);
+    WriteBitcodeToFile(mergedModule, OS);
+  }
 
-  // Run the code generator, and write assembly file
-  codeGenPasses.run(*mergedModule);
+  std::vector<PartitionJob> jobs(_partitions);
+  bool failed = false;
+  for (unsigned i = 0; i != _partitions; ++i) {
+    PartitionJob &job = jobs[i];
+    job.Bitcode = StringRef(bitcode.data(), bitcode.size());
+    job.ModuleID = mergedModule->getModuleIdentifier();
+    job.Partitioning = &partitioning;
+    job.Partition = i;
+    job.Failed = false;
+    job.Target = _target->getTarget().createTargetMachine(
+      _target->getTargetTriple(), _target->getTargetCPU(),
+      _target->getTargetFeatureString(), _target->Options,
+      _target->getRelocationModel(), _target->getCodeModel(),
+      _target->getOptLevel());
+    if (!failed && createTemporaryObjectFile(job.ObjPath, errMsg))
+      failed = true;
+  }
 
-  return false; // success
+  if (!failed)
+    runPartitionJobs(jobs);
+
+  for (unsigned i = 0; i != _partitions; ++i) {
+    PartitionJob &job = jobs[i];
+    delete job.Target;
+    if (job.Failed && !failed) {
+      failed = true;
+      errMsg = job.ErrMsg;
+    }
+    if (!job.ObjPath.empty())
+      _nativeObjectPaths.push_back(job.ObjPath);
+  }
+
+  if (failed) {
+    for (unsigned i = 0, e = _nativeObjectPaths.size(); i != e; ++i)
+      sys::Path(_nativeObjectPaths[i]).eraseFromDisk();
+    _nativeObjectPaths.clear();
+    return true;
+  }
+
+  for (unsigned i = 0, e = _nativeObjectPaths.size(); i != e; ++i)
+    _nativeObjectNames.push_back(_nativeObjectPaths[i].c_str());
+  *names = &_nativeObjectNames[0];
+  *count = _nativeObjectNames.size();
+  return false;
 }
 
 /// setCodeGenDebugOptions - Set codegen debugging options to aid in debugging
@@ -19,6 +19,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Linker.h"
 #include <string>
+#include <vector>
 
 namespace llvm {
   class LLVMContext;
@@ -45,6 +46,8 @@ struct LTOCodeGenerator {
 
   void setCpu(const char* mCpu) { _mCpu = mCpu; }
 
+  void setCodeGenPartitions(unsigned n) { _partitions = n ? n : 1; }
+
   void addMustPreserveSymbol(const char* sym) {
     _mustPreserveSymbols[sym] = 1;
   }
@@ -52,10 +55,14 @@ struct LTOCodeGenerator {
   bool writeMergedModules(const char *path, std::string &errMsg);
   bool compile_to_file(const char **name, std::string &errMsg);
   const void *compile(size_t *length, std::string &errMsg);
+  bool compile_partitions_to_files(const char ***names, unsigned *count,
+                                   std::string &errMsg);
   void setCodeGenDebugOptions(const char *opts);
 
 private:
   bool generateObjectFile(llvm::raw_ostream &out, std::string &errMsg);
+  bool optimizeMergedModule(std::string &errMsg);
+  bool createTemporaryObjectFile(std::string &path, std::string &errMsg);
   void applyScopeRestrictions();
   void applyRestriction(llvm::GlobalValue &GV,
                         std::vector<const char*> &mustPreserveList,
@@ -77,6 +84,9 @@ private:
   std::vector<char*>          _codegenOptions;
   std::string                 _mCpu;
   std::string                 _nativeObjectPath;
+  unsigned                    _partitions;
+  std::vector<std::string>    _nativeObjectPaths;
+  std::vector<const char*>    _nativeObjectNames;
 };
 
 #endif // LTO_CODE_GENERATOR_H
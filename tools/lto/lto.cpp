@@ -206,6 +206,21 @@ bool lto_codegen_compile_to_file(lto_code_gen_t cg, const char **name) {
   return cg->compile_to_file(name, sLastErrorString);
 }
 
+/// lto_codegen_set_partitions - Sets the number of partitions the merged
+/// module is split into for parallel code generation.
+void lto_codegen_set_partitions(lto_code_gen_t cg, unsigned partitions) {
+  cg->setCodeGenPartitions(partitions);
+}
+
+/// lto_codegen_compile_partitions_to_files - Generates code for all added
+/// modules into one native object file per partition. The names of the files
+/// are written to names and their number to count. Returns true on error.
+bool lto_codegen_compile_partitions_to_files(lto_code_gen_t cg,
+                                             const char ***names,
+                                             unsigned *count) {
+  return cg->compile_partitions_to_files(names, count, sLastErrorString);
+}
+
 /// lto_codegen_debug_options - Used to pass extra options to the code
 /// generator.
 void lto_codegen_debug_options(lto_code_gen_t cg, const char *opt) {
@@ -32,6 +32,8 @@
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/PassManager.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/PassNameParser.h"
 #include "llvm/Support/PluginLoader.h"
@@ -41,11 +43,13 @@
 #include "llvm/Support/SystemUtils.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Target/TargetLibraryInfo.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include <algorithm>
+#include <cstdio>
 #include <memory>
 using namespace llvm;
 
@@ -157,6 +161,11 @@ DefaultDataLayout("default-data-layout",
           cl::desc("data layout string to use if not specified by module"),
           cl::value_desc("layout-string"), cl::init(""));
 
+static cl::opt<bool>
+OptServer("server",
+          cl::desc("Read jobs from standard input, one set of arguments "
+                   "per line"));
+
 // ---------- Define Printers for module and function passes ------------
 namespace {
 
@@ -548,6 +557,49 @@ static TargetMachine* GetTargetMachine(Triple TheTriple) {
                                         GetCodeGenOptLevel());
 }
 
+static int optimizeModule(char **argv, LLVMContext &Context);
+
+// runServer - Read jobs from standard input, one per line.  Each line holds
+// the arguments of a single opt invocation; all options are reset before
+// they are parsed, so nothing carries over from earlier jobs.  A line of the
+// form
+//   job <n> exit <status> time <seconds>
+// is written to standard output when each job finishes.
+static int runServer(char **argv) {
+  std::string Line;
+  unsigned JobNum = 0;
+  while (ReadLine(stdin, Line)) {
+    if (StringRef(Line).trim().empty())
+      continue;
+    ++JobNum;
+
+    TimeRecord Start = TimeRecord::getCurrentTime(true);
+    cl::ResetAllOptionOccurrences();
+    cl::ParseCommandLineString(argv[0], Line,
+      "llvm .bc -> .bc modular optimizer and analysis printer\n");
+
+    int RetVal;
+    if (InputFilename == "-" ||
+        (!NoOutput && (OutputFilename.empty() || OutputFilename == "-"))) {
+      errs() << argv[0] << ": server jobs must name their input and output "
+             << "files\n";
+      RetVal = 1;
+    } else {
+      // Every job gets a fresh context so that memory use does not grow with
+      // the number of jobs.
+      LLVMContext Context;
+      RetVal = optimizeModule(argv, Context);
+    }
+
+    TimeRecord Elapsed = TimeRecord::getCurrentTime(false);
+    Elapsed -= Start;
+    outs() << "job " << JobNum << " exit " << RetVal << " time "
+           << format("%.6f", Elapsed.getWallTime()) << '\n';
+    outs().flush();
+  }
+  return 0;
+}
+
 //===----------------------------------------------------------------------===//
 // main for opt
 //
@@ -581,6 +633,13 @@ int main(int argc, char **argv) {
   cl::ParseCommandLineOptions(argc, argv,
     "llvm .bc -> .bc modular optimizer and analysis printer\n");
 
+  if (OptServer)
+    return runServer(argv);
+
+  return optimizeModule(argv, Context);
+}
+
+static int optimizeModule(char **argv, LLVMContext &Context) {
   if (AnalyzeOnly && NoOutput) {
     errs() << argv[0] << ": analyze mode conflicts with no-output mode.\n";
     return 1;
@@ -17,6 +17,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/PassManager.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Mutex.h"
 #include "gtest/gtest.h"
 
 namespace llvm {
@@ -61,5 +62,58 @@ TEST(BitReaderTest, MaterializeFunctionsForBlockAddr) { // PR11677
   passes.run(*m);
 }
 
+static Module *makeModuleWithFunctions(LLVMContext &Context,
+                                       unsigned NumFunctions) {
+  Module *Mod = new Module("test-parallel", Context);
+  FunctionType *FuncTy =
+    FunctionType::get(Type::getVoidTy(Context), false);
+  for (unsigned i = 0; i != NumFunctions; ++i) {
+    Function *Func = Function::Create(FuncTy, GlobalValue::ExternalLinkage,
+                                      "func", Mod);
+    BasicBlock *Entry = BasicBlock::Create(Context, "entry", Func);
+    ReturnInst::Create(Context, Entry);
+  }
+  return Mod;
+}
+
+struct MaterializedCounts {
+  sys::Mutex Lock;
+  unsigned NumCalls;
+  std::vector<unsigned> PerFunction;
+};
+
+static void countMaterialized(Module *M, unsigned Partition, void *Cookie) {
+  MaterializedCounts &Counts = *static_cast<MaterializedCounts*>(Cookie);
+  sys::ScopedLock Guard(Counts.Lock);
+  ++Counts.NumCalls;
+  unsigned i = 0;
+  for (Module::iterator F = M->begin(), E = M->end(); F != E; ++F, ++i)
+    if (!F->isMaterializable() && !F->isDeclaration())
+      ++Counts.PerFunction[i];
+}
+
+TEST(BitReaderTest, MaterializeInParallel) {
+  const unsigned NumFunctions = 10;
+  SmallString<1024> Mem;
+  {
+    LLVMContext Context;
+    OwningPtr<Module> Mod(makeModuleWithFunctions(Context, NumFunctions));
+    raw_svector_ostream OS(Mem);
+    WriteBitcodeToFile(Mod.get(), OS);
+  }
+  OwningPtr<MemoryBuffer> Buffer(
+    MemoryBuffer::getMemBuffer(Mem.str(), "test", false));
+
+  MaterializedCounts Counts;
+  Counts.NumCalls = 0;
+  Counts.PerFunction.resize(NumFunctions);
+  std::string ErrMsg;
+  EXPECT_TRUE(materializeBitcodeInParallel(Buffer.get(), 3, countMaterialized,
+                                           &Counts, &ErrMsg));
+  EXPECT_EQ(3U, Counts.NumCalls);
+  for (unsigned i = 0; i != NumFunctions; ++i)
+    EXPECT_EQ(1U, Counts.PerFunction[i]);
+}
+
 }
 }
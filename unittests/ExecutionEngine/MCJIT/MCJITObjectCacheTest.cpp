@@ -11,10 +11,14 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/ExecutionEngine/FileObjectCache.h"
 #include "llvm/ExecutionEngine/JIT.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include "MCJITTestBase.h"
 #include "gtest/gtest.h"
 
@@ -117,6 +121,37 @@ protected:
   Function *Main;
 };
 
+class FileObjectCacheTest : public MCJITObjectCacheTest {
+protected:
+  virtual void SetUp() {
+    MCJITObjectCacheTest::SetUp();
+
+    // Reserve a unique name, then use it as the cache directory.
+    int FD;
+    ASSERT_FALSE(sys::fs::unique_file("fileobjcache-%%%%%%", FD, CacheDir));
+    ::close(FD);
+    bool Existed;
+    ASSERT_FALSE(sys::fs::remove(CacheDir.str(), Existed));
+  }
+
+  virtual void TearDown() {
+    uint32_t Removed;
+    sys::fs::remove_all(CacheDir.str(), Removed);
+  }
+
+  unsigned countCachedObjects() {
+    unsigned Count = 0;
+    error_code EC;
+    for (sys::fs::directory_iterator I(CacheDir.str(), EC), E; I != E && !EC;
+         I.increment(EC))
+      if (sys::path::extension(I->path()) == ".o")
+        ++Count;
+    return Count;
+  }
+
+  SmallString<128> CacheDir;
+};
+
 TEST_F(MCJITObjectCacheTest, SetNullObjectCache) {
   SKIP_UNSUPPORTED_PLATFORM;
 
@@ -236,5 +271,69 @@ TEST_F(MCJITObjectCacheTest, VerifyNonLoadFromCache) {
   EXPECT_FALSE(Cache->wereDuplicatesInserted());
 }
 
+TEST_F(FileObjectCacheTest, CacheKey) {
+  FileObjectCache Cache(CacheDir);
+  FileObjectCache OtherCPU(CacheDir, "other-cpu");
+  FileObjectCache OtherOptLevel(CacheDir, "", "", CodeGenOpt::Aggressive);
+
+  OwningPtr<Module> Same(createEmptyModule("<main>"));
+  insertMainFunction(Same.get(), OriginalRC);
+  OwningPtr<Module> Different(createEmptyModule("<main>"));
+  insertMainFunction(Different.get(), ReplacementRC);
+
+  std::string Path = Cache.getCachePath(M.get());
+  EXPECT_EQ(Path, Cache.getCachePath(M.get()));
+  EXPECT_EQ(Path, Cache.getCachePath(Same.get()));
+  EXPECT_NE(Path, Cache.getCachePath(Different.get()));
+  EXPECT_NE(Path, OtherCPU.getCachePath(M.get()));
+  EXPECT_NE(Path, OtherOptLevel.getCachePath(M.get()));
+}
+
+TEST_F(FileObjectCacheTest, VerifyLoadFromDisk) {
+  SKIP_UNSUPPORTED_PLATFORM;
+
+  std::string OriginalPath;
+  {
+    FileObjectCache Cache(CacheDir);
+    OriginalPath = Cache.getCachePath(M.get());
+    createJIT(M.take());
+    TheJIT->setObjectCache(&Cache);
+    compileAndRun();
+    TheJIT.reset();
+  }
+
+  bool Exists;
+  ASSERT_FALSE(sys::fs::exists(OriginalPath, Exists));
+  ASSERT_TRUE(Exists);
+  EXPECT_EQ(1u, countCachedObjects());
+
+  // Install the cached object under the key of a module with a different
+  // return code.  Seeing the original return code proves that the object was
+  // read back from disk rather than compiled.
+  MM = new SectionMemoryManager;
+  M.reset(createEmptyModule("<main>"));
+  Main = insertMainFunction(M.get(), ReplacementRC);
+
+  FileObjectCache Cache(CacheDir);
+  ASSERT_FALSE(sys::fs::copy_file(OriginalPath, Cache.getCachePath(M.get())));
+
+  createJIT(M.take());
+  TheJIT->setObjectCache(&Cache);
+  compileAndRun(OriginalRC);
+}
+
+TEST_F(FileObjectCacheTest, EvictBySize) {
+  FileObjectCache Cache(CacheDir, "", "", CodeGenOpt::Default, 150);
+
+  OwningPtr<MemoryBuffer> Obj(
+    MemoryBuffer::getMemBufferCopy(std::string(100, 'x')));
+  OwningPtr<Module> Other(createEmptyModule("<other>"));
+
+  Cache.notifyObjectCompiled(M.get(), Obj.get());
+  EXPECT_EQ(1u, countCachedObjects());
+  Cache.notifyObjectCompiled(Other.get(), Obj.get());
+  EXPECT_EQ(1u, countCachedObjects());
+}
+
 } // Namespace
 
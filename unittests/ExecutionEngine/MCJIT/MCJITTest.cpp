@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
 #include "MCJITTestBase.h"
 #include "gtest/gtest.h"
@@ -201,8 +202,6 @@ TEST_F(MCJITTest, multiple_empty_modules) {
 }
 */
 
-// FIXME: MCJIT must support multiple modules
-/*
 TEST_F(MCJITTest, multiple_modules) {
   SKIP_UNSUPPORTED_PLATFORM;
 
@@ -212,24 +211,72 @@ TEST_F(MCJITTest, multiple_modules) {
   // caller function is defined in a different module
   M.reset(createEmptyModule("<caller module>"));
 
-  Function *CalleeRef = insertExternalReferenceToFunction(M.get(), Callee);
-  Function *Caller = insertSimpleCallFunction(M.get(), CalleeRef);
+  Function *CalleeRef = insertExternalReferenceToFunction(
+      M.get(), Callee->getName(), Callee->getFunctionType());
+  Function *Caller =
+    insertSimpleCallFunction<int32_t(int32_t, int32_t)>(M.get(), CalleeRef);
 
   TheJIT->addModule(M.take());
 
   // get a function pointer in a module that was not used in EE construction
   void *vPtr = TheJIT->getPointerToFunction(Caller);
-  EXPECT_NE(0, vPtr)
+  MM->applyPermissions();
+  static_cast<SectionMemoryManager*>(MM)->invalidateInstructionCache();
+  EXPECT_TRUE(0 != vPtr)
     << "Unable to get pointer to caller function from JIT";
 
   int(*FuncPtr)(int, int) = (int(*)(int, int))(intptr_t)vPtr;
   EXPECT_EQ(0, FuncPtr(0, 0));
   EXPECT_EQ(30, FuncPtr(10, 20));
   EXPECT_EQ(-30, FuncPtr(-10, -20));
+}
+
+class CountingListener : public JITEventListener {
+public:
+  CountingListener() : NumObjectsEmitted(0) {}
+  virtual void NotifyObjectEmitted(const ObjectImage &) {
+    ++NumObjectsEmitted;
+  }
+  unsigned NumObjectsEmitted;
+};
+
+TEST_F(MCJITTest, lazy_module_compilation) {
+  SKIP_UNSUPPORTED_PLATFORM;
+
+  // Three modules: "add" is referenced from "caller", "unused" is not.
+  Function *Callee = insertAddFunction(M.get());
+  createJIT(M.take());
+  CountingListener Listener;
+  TheJIT->RegisterJITEventListener(&Listener);
+
+  M.reset(createEmptyModule("<unused module>"));
+  insertAddFunction(M.get(), "unused");
+  TheJIT->addModule(M.take());
+
+  M.reset(createEmptyModule("<caller module>"));
+  Function *CalleeRef = insertExternalReferenceToFunction(
+      M.get(), Callee->getName(), Callee->getFunctionType());
+  Function *Caller =
+    insertSimpleCallFunction<int32_t(int32_t, int32_t)>(M.get(), CalleeRef);
+  TheJIT->addModule(M.take());
+
+  EXPECT_EQ(0u, Listener.NumObjectsEmitted);
+
+  // Requesting the caller compiles its module and the module it calls into,
+  // but not the unrelated one.
+  void *vPtr = TheJIT->getPointerToFunction(Caller);
+  EXPECT_EQ(2u, Listener.NumObjectsEmitted);
+  MM->applyPermissions();
+  static_cast<SectionMemoryManager*>(MM)->invalidateInstructionCache();
 
-  // ensure caller is destroyed before callee (free use before def)
-  M.reset();
+  int(*FuncPtr)(int, int) = (int(*)(int, int))(intptr_t)vPtr;
+  EXPECT_EQ(30, FuncPtr(10, 20));
+
+  // Asking again does not recompile anything.
+  EXPECT_EQ(vPtr, TheJIT->getPointerToFunction(Caller));
+  EXPECT_EQ(2u, Listener.NumObjectsEmitted);
+
+  TheJIT->UnregisterJITEventListener(&Listener);
 }
-*/
 
 }
@@ -9,8 +9,10 @@
 
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/InlineAsm.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "gtest/gtest.h"
@@ -151,6 +153,70 @@ TEST(ConstantsTest, PointerCast) {
               Constant::getNullValue(Int8PtrVecTy), Int32PtrVecTy));
 }
 
+TEST(ConstantsTest, ConstantExprUniquing) {
+  LLVMContext Context;
+  OwningPtr<Module> M(new Module("MyModule", Context));
+  Type *Int32Ty = Type::getInt32Ty(Context);
+  Type *Int64Ty = Type::getInt64Ty(Context);
+  Type *Int32PtrTy = PointerType::getUnqual(Int32Ty);
+
+  Constant *G1 = M->getOrInsertGlobal("g1", Int32Ty);
+  Constant *G2 = M->getOrInsertGlobal("g2", Int32Ty);
+
+  // Structurally identical expressions are uniqued to the same object, while
+  // differences in opcode, flags, predicate, type or indices are not.
+  Constant *P1 = ConstantExpr::getPtrToInt(G1, Int64Ty);
+  EXPECT_EQ(P1, ConstantExpr::getPtrToInt(G1, Int64Ty));
+  EXPECT_NE(P1, ConstantExpr::getPtrToInt(G1, Int32Ty));
+  EXPECT_NE(P1, ConstantExpr::getPtrToInt(G2, Int64Ty));
+
+  Constant *Add = ConstantExpr::getAdd(P1, P1);
+  EXPECT_EQ(Add, ConstantExpr::getAdd(P1, P1));
+  EXPECT_NE(Add, ConstantExpr::getAdd(P1, P1, /*HasNUW=*/true));
+  EXPECT_NE(Add, ConstantExpr::getSub(P1, P1));
+
+  Constant *Cmp = ConstantExpr::getICmp(CmpInst::ICMP_EQ, P1, Add);
+  EXPECT_EQ(Cmp, ConstantExpr::getICmp(CmpInst::ICMP_EQ, P1, Add));
+  EXPECT_NE(Cmp, ConstantExpr::getICmp(CmpInst::ICMP_NE, P1, Add));
+
+  Constant *Idx = ConstantInt::get(Int32Ty, 1);
+  Constant *GEP = ConstantExpr::getGetElementPtr(G1, Idx);
+  EXPECT_EQ(GEP, ConstantExpr::getGetElementPtr(G1, Idx));
+  EXPECT_NE(GEP, ConstantExpr::getGetElementPtr(G1, ConstantInt::get(Int32Ty,
+                                                                    2)));
+  EXPECT_EQ(Int32PtrTy, GEP->getType());
+
+  // Replacing an operand re-uniques the users: after G2 is replaced by G1
+  // every expression over G2 must collapse onto its existing G1 twin.
+  Constant *P2 = ConstantExpr::getPtrToInt(G2, Int64Ty);
+  Constant *Add2 = ConstantExpr::getAdd(P2, P2);
+  Constant *GEP2 = ConstantExpr::getGetElementPtr(G2, Idx);
+  GlobalVariable *GV = new GlobalVariable(*M, Int32PtrTy, false,
+                                          GlobalValue::ExternalLinkage, GEP2);
+  Function *F = cast<Function>(M->getOrInsertFunction(
+      "f", FunctionType::get(Int64Ty, false)));
+  ReturnInst::Create(Context, Add2, BasicBlock::Create(Context, "", F));
+  G2->replaceAllUsesWith(G1);
+  EXPECT_EQ(GEP, GV->getInitializer());
+  EXPECT_EQ(Add, F->getEntryBlock().getTerminator()->getOperand(0));
+
+  // The tables remain consistent after destroying constants.
+  EXPECT_EQ(P1, ConstantExpr::getPtrToInt(G1, Int64Ty));
+  EXPECT_EQ(Add, ConstantExpr::getAdd(P1, P1));
+  EXPECT_EQ(GEP, ConstantExpr::getGetElementPtr(G1, Idx));
+}
+
+TEST(ConstantsTest, InlineAsmUniquing) {
+  LLVMContext Context;
+  FunctionType *FTy = FunctionType::get(Type::getVoidTy(Context), false);
+  InlineAsm *A = InlineAsm::get(FTy, "nop", "", true);
+  EXPECT_EQ(A, InlineAsm::get(FTy, "nop", "", true));
+  EXPECT_NE(A, InlineAsm::get(FTy, "nop", "", false));
+  EXPECT_NE(A, InlineAsm::get(FTy, "nop", "~{memory}", true));
+  EXPECT_NE(A, InlineAsm::get(FTy, "nop", "", true, false,
+                              InlineAsm::AD_Intel));
+}
+
 #define CHECK(x, y) {                                         		\
     std::string __s;                                            	\
     raw_string_ostream __o(__s);                                	\
@@ -41,6 +41,36 @@ class TempEnvVar {
   const char *const name;
 };
 
+cl::opt<std::string> ResetTestString("reset-test-string", cl::init("default"));
+cl::opt<unsigned> ResetTestUnsigned("reset-test-unsigned");
+cl::list<std::string> ResetTestList("reset-test-list");
+TEST(CommandLineTest, ResetAllOptionOccurrences) {
+  const char *Args1[] = { "prog", "-reset-test-string=one",
+                          "-reset-test-unsigned=3", "-reset-test-list=a",
+                          "-reset-test-list=b" };
+  cl::ParseCommandLineOptions(5, Args1);
+  EXPECT_EQ("one", ResetTestString);
+  EXPECT_EQ(3U, ResetTestUnsigned);
+  EXPECT_EQ(2U, ResetTestList.size());
+  EXPECT_EQ(1, ResetTestString.getNumOccurrences());
+
+  cl::ResetAllOptionOccurrences();
+  EXPECT_EQ("default", ResetTestString);
+  EXPECT_EQ(0U, ResetTestUnsigned);
+  EXPECT_TRUE(ResetTestList.empty());
+  EXPECT_EQ(0, ResetTestString.getNumOccurrences());
+
+  // A second parse must not see anything left over from the first.
+  const char *Args2[] = { "prog", "-reset-test-list=c" };
+  cl::ParseCommandLineOptions(2, Args2);
+  EXPECT_EQ("default", ResetTestString);
+  ASSERT_EQ(1U, ResetTestList.size());
+  EXPECT_EQ("c", ResetTestList[0]);
+  EXPECT_EQ(1U, ResetTestList.getPosition(0));
+
+  cl::ResetAllOptionOccurrences();
+}
+
 #ifndef SKIP_ENVIRONMENT_TESTS
 
 const char test_env_var[] = "LLVM_TEST_COMMAND_LINE_FLAGS";
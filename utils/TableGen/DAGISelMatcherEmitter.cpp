@@ -30,6 +30,12 @@ static cl::opt<bool>
 OmitComments("omit-comments", cl::desc("Do not generate comments"),
              cl::init(false));
 
+static cl::opt<bool>
+EmitOpcodeIndex("emit-opcode-index",
+                cl::desc("Emit a switch that maps the root opcode to its case "
+                         "in the matcher table"),
+                cl::init(true));
+
 namespace {
 class MatcherTableEmitter {
   const CodeGenDAGPatterns &CGP;
@@ -47,6 +53,10 @@ class MatcherTableEmitter {
   DenseMap<Record*, unsigned> NodeXFormMap;
   std::vector<Record*> NodeXForms;
 
+  /// RootOpcodeCases - If the table starts with an OPC_SwitchOpcode, the enum
+  /// name and table index of each of its cases.
+  std::vector<std::pair<std::string, unsigned> > RootOpcodeCases;
+
 public:
   MatcherTableEmitter(const CodeGenDAGPatterns &cgp)
     : CGP(cgp) {}
@@ -57,6 +67,8 @@ public:
   void EmitPredicateFunctions(formatted_raw_ostream &OS);
 
   void EmitHistogram(const Matcher *N, formatted_raw_ostream &OS);
+
+  void EmitRootOpcodeIndex(formatted_raw_ostream &OS);
 private:
   unsigned EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
                        formatted_raw_ostream &OS);
@@ -332,6 +344,11 @@ EmitMatcher(const Matcher *N, unsigned Indent, unsigned CurrentIdx,
 
       CurrentIdx += IdxSize;
 
+      if (StartIdx == 0)
+        if (const SwitchOpcodeMatcher *SOM = dyn_cast<SwitchOpcodeMatcher>(N))
+          RootOpcodeCases.push_back(std::make_pair(
+              SOM->getCaseOpcode(i).getEnumName(), CurrentIdx));
+
       if (!OmitComments)
         OS << "// ->" << CurrentIdx+ChildSize;
       OS << '\n';
@@ -729,6 +746,24 @@ static void BuildHistogram(const Matcher *M, std::vector<unsigned> &OpcodeFreq){
   }
 }
 
+/// EmitRootOpcodeIndex - Emit a switch that finds where matching starts for
+/// the opcode of N, so SelectCodeCommon does not have to search the table.
+void MatcherTableEmitter::EmitRootOpcodeIndex(formatted_raw_ostream &OS) {
+  OS << "  // Index of the first matcher for the root opcode.\n";
+  OS << "  unsigned MatcherIndex = 0;\n";
+  if (RootOpcodeCases.empty()) {
+    OS << '\n';
+    return;
+  }
+
+  OS << "  switch (N->getOpcode()) {\n";
+  OS << "  default: break;\n";
+  for (unsigned i = 0, e = RootOpcodeCases.size(); i != e; ++i)
+    OS << "  case " << RootOpcodeCases[i].first << ": MatcherIndex = "
+       << RootOpcodeCases[i].second << "; break;\n";
+  OS << "  }\n\n";
+}
+
 void MatcherTableEmitter::EmitHistogram(const Matcher *M,
                                         formatted_raw_ostream &OS) {
   if (OmitComments)
@@ -804,7 +839,13 @@ void llvm::EmitMatcherTable(const Matcher *TheMatcher,
   MatcherEmitter.EmitHistogram(TheMatcher, OS);
 
   OS << "  #undef TARGET_VAL\n";
-  OS << "  return SelectCodeCommon(N, MatcherTable,sizeof(MatcherTable));\n}\n";
+  if (EmitOpcodeIndex) {
+    MatcherEmitter.EmitRootOpcodeIndex(OS);
+    OS << "  return SelectCodeCommon(N, MatcherTable, sizeof(MatcherTable),\n"
+       << "                          MatcherIndex);\n}\n";
+  } else {
+    OS << "  return SelectCodeCommon(N, MatcherTable,sizeof(MatcherTable));\n}\n";
+  }
   OS << '\n';
 
   // Next up, emit the function for node and pattern predicates: